@@ -40,10 +40,10 @@ Board::Board(int rows, int cols, int start_y, int start_x, WINDOW* border_window
 void Board::reset()
 {
     // snake_one starts at top left
-    snake_one = snake::Snake(1, 1, snake::Direction::down, 1);
+    snake_one = snake::Snake(rows, cols, 1, 1, snake::Direction::down, 1);
 
     // snake_two starts at bottom right
-    snake_two = snake::Snake(rows - 2, cols - 2, snake::Direction::up, 1);
+    snake_two = snake::Snake(rows, cols, rows - 2, cols - 2, snake::Direction::up, 1);
 
     state = State::active;
     collide_one = false;
@@ -112,11 +112,8 @@ bool Board::check_collision(Player player) const
     }
     // check collision with both snakes.
     for (const auto& other_player : {Player::one, Player::two}) {
-        const snake::Snake& other_snake = get_snake(other_player);
-        for (auto it = other_snake.chain.begin(); it != other_snake.chain.end(); ++it) {
-            if (next_head == *it) {
-                return true;
-            }
+        if (get_snake(other_player).occupies(next_head.first, next_head.second)) {
+            return true;
         }
     }
     // check collision with other snake next head.
@@ -0,0 +1,102 @@
+#include <ngames/common/histogram.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include <cassert>
+
+
+namespace ngames
+{
+
+Histogram::Histogram() : count(0), sum(0), min(std::numeric_limits<uint64_t>::max()), max(0)
+{
+    buckets.fill(0);
+}
+
+void Histogram::record(uint64_t value)
+{
+    ++buckets[bucket_of(value)];
+    ++count;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void Histogram::merge(const Histogram& other)
+{
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        buckets[bucket] += other.buckets[bucket];
+    }
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+uint64_t Histogram::percentile(double percent) const
+{
+    assert(0 <= percent && percent <= 100);  // percent must be valid
+
+    if (count == 0) {
+        return 0;
+    }
+    // number of values that must be no larger than the result
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percent / 100 * count + 0.5));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= target) {
+            // upper end of the bucket, but never more than the largest value
+            const uint64_t upper = bucket + 1 < NUM_BUCKETS ? bucket_lower(bucket + 1) - 1 : max;
+            return std::min(upper, max);
+        }
+    }
+    return max;
+}
+
+void Histogram::print(FILE* file, double scale) const
+{
+    constexpr int BAR_WIDTH = 50;
+
+    uint64_t largest = 0;
+    for (const uint64_t bucket_count : buckets) {
+        largest = std::max(largest, bucket_count);
+    }
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        if (buckets[bucket] == 0) {
+            continue;
+        }
+        const int width = static_cast<int>(buckets[bucket] * BAR_WIDTH / largest);
+        fprintf(
+            file,
+            "  >= %12.1f  %10llu  %.*s\n",
+            bucket_lower(bucket) / scale,
+            static_cast<unsigned long long>(buckets[bucket]),
+            std::max(width, 1),
+            "##################################################");
+    }
+}
+
+int Histogram::bucket_of(uint64_t value)
+{
+    if (value < SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    const int msb = 63 - std::countl_zero(value);
+    const int sub = static_cast<int>(value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucket_lower(int bucket)
+{
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    const int msb = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    const uint64_t sub = bucket % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS);
+}
+
+}  // namespace ngames
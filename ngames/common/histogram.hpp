@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+
+namespace ngames
+{
+
+/**
+ * Histogram of non-negative values, e.g. latencies in nanoseconds, with
+ * logarithmically sized buckets. Each power of two is split into
+ * `SUB_BUCKETS` buckets, so values are resolved to within 1 / `SUB_BUCKETS`
+ * of their size. Recording a value takes constant time and never allocates.
+ */
+class Histogram
+{
+public:
+    // Number of buckets per power of two is 2^SUB_BUCKET_BITS.
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    Histogram();
+
+    /**
+     * Record a value.
+     * @param value Value.
+     */
+    void record(uint64_t value);
+
+    /**
+     * Add all values recorded by another histogram.
+     * @param other Histogram.
+     */
+    void merge(const Histogram& other);
+
+    /**
+     * Return an upper bound for the value at a percentile, i.e. at least
+     * `percent` of recorded values are no larger than it.
+     * @param percent Percentile, between 0 and 100.
+     */
+    uint64_t percentile(double percent) const;
+
+    /**
+     * Print the non-empty buckets as a bar chart.
+     * @param file File to print to.
+     * @param scale Values are divided by this before printing, e.g. 1000 to
+     * print nanoseconds as microseconds.
+     */
+    void print(FILE* file, double scale = 1.0) const;
+
+    inline uint64_t get_count() const { return count; }
+
+    inline uint64_t get_min() const { return count > 0 ? min : 0; }
+
+    inline uint64_t get_max() const { return max; }
+
+    inline double get_mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+
+private:
+    // Values below `SUB_BUCKETS` get a bucket each; above that, each power of
+    // two gets `SUB_BUCKETS` buckets.
+    static constexpr int NUM_BUCKETS = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+    /**
+     * Return bucket index of a value.
+     */
+    static int bucket_of(uint64_t value);
+
+    /**
+     * Return smallest value in a bucket.
+     */
+    static uint64_t bucket_lower(int bucket);
+
+    std::array<uint64_t, NUM_BUCKETS> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+}  // namespace ngames
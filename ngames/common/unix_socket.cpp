@@ -0,0 +1,48 @@
+#include <ngames/common/unix_socket.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace ngames
+{
+
+int listen_unix(const char* path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return -1;
+    }
+    std::strcpy(address.sun_path, path);
+
+    // only replace a stale socket, never another file at a mistyped path
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "Not a socket: %s\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    const int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return -1;
+    }    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0) {
+        perror(path);
+        close(listen_fd);
+        return -1;
+    }
+    return listen_fd;
+}
+
+}  // namespace ngames
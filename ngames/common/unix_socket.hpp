@@ -0,0 +1,16 @@
+#pragma once
+
+
+namespace ngames
+{
+
+/**
+ * Create a Unix domain stream socket listening on a path. Errors are printed
+ * to stderr.
+ * @param path Path of the socket. An existing socket is replaced, while any
+ * other existing file is an error.
+ * @returns Listening socket, or -1 if an error occurred.
+ */
+int listen_unix(const char* path);
+
+}  // namespace ngames
@@ -0,0 +1,121 @@
+#include <ngames/common/work_stealing_pool.hpp>
+
+#include <cassert>
+
+
+namespace ngames
+{
+
+WorkStealingPool::WorkStealingPool(int num_threads) : job(nullptr), batch(0), busy(0), stopping(false)
+{
+    assert(num_threads > 0);
+    for (int thread = 0; thread < num_threads; ++thread) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    // the caller of `run()` acts as thread 0
+    for (int thread = 1; thread < num_threads; ++thread) {
+        threads.emplace_back(&WorkStealingPool::loop, this, thread);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::run(int num_tasks, const std::function<void(int, int)>& f)
+{
+    if (threads.empty() || num_tasks <= 1) {
+        for (int task = 0; task < num_tasks; ++task) {
+            f(task, 0);
+        }
+        return;
+    }
+
+    // deal tasks in turn, so each queue starts with the earliest tasks
+    const int num_threads = get_num_threads();
+    for (int task = 0; task < num_tasks; ++task) {
+        Queue& queue = *queues[task % num_threads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &f;
+        busy = static_cast<int>(threads.size());
+        ++batch;
+    }
+    start.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+bool WorkStealingPool::pop(int thread, int& task)
+{
+    const int num_threads = get_num_threads();
+    for (int i = 0; i < num_threads; ++i) {
+        const int victim = (thread + i) % num_threads;
+        Queue& queue = *queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (victim == thread) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        } else {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::work(int thread)
+{
+    int task;
+    while (pop(thread, task)) {
+        (*job)(task, thread);
+    }
+}
+
+void WorkStealingPool::loop(int thread)
+{
+    uint64_t last_batch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start.wait(lock, [&] { return stopping || batch != last_batch; });
+            if (stopping) {
+                return;
+            }
+            last_batch = batch;
+        }
+
+        work(thread);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = --busy == 0;
+        }
+        if (last) {
+            done.notify_one();
+        }
+    }
+}
+
+}  // namespace ngames
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ngames
+{
+
+/**
+ * Fixed pool of threads running batches of independent tasks. Each thread
+ * has its own queue of tasks, and a thread whose queue runs dry steals tasks
+ * from the queues of the others, so a few slow tasks do not leave threads
+ * idle while others still have work queued.
+ *
+ * Tasks are identified by their index in the batch, so callers can write
+ * results into per-task slots and merge them in index order, which keeps
+ * results independent of the number of threads.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * Start the threads.
+     * @param num_threads Number of threads running tasks, including the
+     * thread calling `run()`.
+     */
+    WorkStealingPool(int num_threads);
+
+    /**
+     * Stop the threads.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    inline int get_num_threads() const { return static_cast<int>(queues.size()); }
+
+    /**
+     * Run a batch of tasks and wait for all of them to finish. Tasks are dealt
+     * to the queues in index order, so tasks listed first, e.g. the largest,
+     * start first. Not thread-safe, i.e. only one batch runs at a time.
+     * @param num_tasks Number of tasks.
+     * @param f Function called as `f(task, thread)` for each task, where
+     * `thread` is the index of the thread running it, e.g. to pick scratch
+     * memory.
+     */
+    void run(int num_tasks, const std::function<void(int, int)>& f);
+
+private:
+    /**
+     * Tasks of a thread. The thread takes tasks from the front, and thieves
+     * from the back.
+     */
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    /**
+     * Take a task from the queue of a thread, or steal one from another queue.
+     * @param thread Index of the thread.
+     * @param task Set to the task.
+     * @returns False if all queues are empty.
+     */
+    bool pop(int thread, int& task);
+
+    /**
+     * Run tasks until all queues are empty.
+     * @param thread Index of the thread.
+     */
+    void work(int thread);
+
+    /**
+     * Body of the threads other than the caller of `run()`.
+     * @param thread Index of the thread.
+     */
+    void loop(int thread);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    // Guards the fields below.
+    std::mutex mutex;
+    // Signals a new batch, or stopping.
+    std::condition_variable start;
+    // Signals that all threads are done with the batch.
+    std::condition_variable done;
+    // Function of the current batch.
+    const std::function<void(int, int)>* job;
+    // Incremented for each batch.
+    uint64_t batch;
+    // Threads still working on the current batch, excluding the caller.
+    int busy;
+    bool stopping;
+};
+
+}  // namespace ngames
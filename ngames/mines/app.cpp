@@ -2,46 +2,240 @@
 
 #include <ngames/mines/ui.hpp>
 
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <cassert>
+#include <cerrno>
+
+#include <poll.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+inline std::chrono::steady_clock::time_point now()
+{
+    return std::chrono::steady_clock::now();
+}
+
+}  // namespace
+
 
 namespace ngames::mines
 {
 
-App::App(int rows, int cols, int mines)
+App::App(int rows,
+         int cols,
+         int mines,
+         FILE* record_file,
+         Autosaver* autosaver,
+         CoopClient* coop,
+         Telemetry* telemetry,
+         const Snapshot* snapshot,
+         std::optional<unsigned> seed)
     : cursor_y((rows - 1) / 2),
       cursor_x((cols - 1) / 2),
       text_mine_count(board, MARGIN_TOP, MARGIN_LEFT),
       board_border(rows, cols, text_mine_count.bottom(), MARGIN_LEFT),
-      board(rows, cols, mines, board_border.inner_start_y(), board_border.inner_start_x(), board_border.window),
+      board(rows,
+            cols,
+            mines,
+            seed.has_value() ? *seed : std::random_device()(),
+            board_border.inner_start_y(),
+            board_border.inner_start_x(),
+            board_border.window),
       text_end_game(board, board_border.bottom(), MARGIN_LEFT),
-      text_instructions(text_end_game.bottom(), MARGIN_LEFT)
+      text_instructions(text_end_game.bottom(), MARGIN_LEFT),
+      hint_budget(Hinter::DEFAULT_BUDGET),
+      needs_refresh(false),
+      autosaver(autosaver),
+      coop(coop),
+      telemetry(telemetry),
+      start_time(now())
 {
+    if (Minimap::is_needed(rows, cols)) {
+        // place minimap to the right of the board
+        minimap_border.emplace(
+            Minimap::rows_for(rows), Minimap::cols_for(cols), board_border.top(), board_border.right() + MARGIN_LEFT);
+        minimap.emplace(board, minimap_border->inner_start_y(), minimap_border->inner_start_x(), minimap_border->window);
+    }
+
     init_colors();
     keypad(board.window, true);                            // allow arrow keys
     mousemask(BUTTON1_RELEASED | BUTTON3_RELEASED, NULL);  // allow mouse
     mouseinterval(0);                                      // do not wait to distinguish clicks; more reactive interface
 
+    if (record_file != nullptr) {
+        recorder.emplace(record_file, ReplayHeader{.rows = rows, .cols = cols, .mines = mines, .seed = board.get_seed()});
+    }
+
+    if (snapshot != nullptr) {
+        assert(snapshot->rows == rows && snapshot->cols == cols);  // snapshot must match board
+        board.restore(snapshot->seed, snapshot->first_opened, snapshot->cells.data());
+    }
+    // NOTE: only once restored, so that resuming never saves a new game over
+    // the one being resumed
+    autosave();
+
     // initial print
     refresh();
 }
 
+void App::set_hint_budget(std::chrono::milliseconds budget)
+{
+    hint_budget = budget;
+    hinter.reset();
+}
+
 void App::refresh() const
 {
+    if (telemetry != nullptr) {
+        telemetry->render_start();
+    }
     text_mine_count.refresh();
     board_border.refresh();
     board.refresh();
     text_end_game.refresh();
     text_instructions.refresh();
+    if (minimap.has_value()) {
+        minimap_border->refresh();
+        minimap->refresh();
+    }
+    if (telemetry != nullptr) {
+        telemetry->output_start();
+    }
     doupdate();
+    if (telemetry != nullptr) {
+        telemetry->render_end();
+    }
 }
 
 void App::run()
 {
-    while (true) {
+    if (coop != nullptr) {
+        run_coop();
+        return;
+    }
+    bool running = true;
+    while (running) {
+        // NOTE: moving the cursor alone is shown by `wgetch()`, which only
+        // sends the cursor position when nothing else changed
         wmove(board.window, cursor_y, cursor_x);
-        const int key = wgetch(board.window);
-        if (!handle_keystroke(key)) {
+        // while a hint is computed, wake up regularly to show it once ready
+        const bool hint_pending = is_hint_pending();
+        wtimeout(board.window, hint_pending ? HINT_POLL_MS : -1);
+        int key = wgetch(board.window);
+        if (key == ERR) {
+            if (hint_pending) {
+                show_hint();
+            }
+            continue;
+        }
+
+        // handle all input already waiting, e.g. from key repeat or a script,
+        // and then refresh once
+        wtimeout(board.window, 0);
+        do {
+            running = handle_input(key);
+        } while (running && (key = wgetch(board.window)) != ERR);
+        end_batch();
+    }
+    wtimeout(board.window, -1);
+}
+
+void App::run_coop()
+{
+    // handle keystrokes without waiting, and wait for either input instead
+    wtimeout(board.window, 0);
+    std::array<pollfd, 2> fds = {{
+        {.fd = STDIN_FILENO, .events = POLLIN, .revents = 0},
+        {.fd = coop->get_fd(), .events = POLLIN, .revents = 0},
+    }};
+    bool running = true;
+    while (running) {
+        wmove(board.window, cursor_y, cursor_x);
+        const bool hint_pending = is_hint_pending();
+        if (poll(fds.data(), fds.size(), hint_pending ? HINT_POLL_MS : -1) < 0 && errno != EINTR) {
             break;
         }
+        if (hint_pending) {
+            show_hint();
+        }
+
+        if (fds[1].revents != 0) {
+            if (!coop->receive(board)) {
+                // server went away
+                break;
+            }
+            needs_refresh = true;
+        }
+        // NOTE: ncurses may have buffered several keystrokes, so read them all
+        int key;
+        while (running && (key = wgetch(board.window)) != ERR) {
+            running = handle_input(key);
+        }
+        end_batch();
+    }
+    wtimeout(board.window, -1);
+}
+
+void App::replay(ReplayReader& reader, double speed)
+{
+    refresh();
+
+    const auto replay_start_time = now();
+    ReplayEvent event;
+    bool quit = false;
+    while (reader.read_event(event)) {
+        // wait until the event is due, while polling for quit
+        auto due = replay_start_time;
+        if (speed > 0) {
+            const std::chrono::duration<double, std::milli> event_time(event.time_ms / speed);
+            due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(event_time);
+        }
+        do {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(due - now());
+            wtimeout(board.window, std::max(static_cast<int>(remaining.count()), 0));
+            quit = wgetch(board.window) == 'q';
+        } while (!quit && now() < due);
+        if (quit) {
+            break;
+        }
+
+        if (event.action != ReplayEvent::Action::reset) {
+            cursor_y = event.row;
+            cursor_x = event.col;
+        }
+        if (apply_event(board, event) == 0) {
+            refresh();
+        }
+        wmove(board.window, cursor_y, cursor_x);
+    }
+    // restore blocking input
+    wtimeout(board.window, -1);
+}
+
+bool App::handle_input(int key)
+{
+    if (telemetry != nullptr) {
+        telemetry->input_start(key == KEY_MOUSE);
+    }
+    return handle_keystroke(key);
+}
+
+void App::end_batch()
+{
+    if (needs_refresh) {
+        // NOTE: before refreshing, which clears the changed cells of the board
+        autosave();
+        refresh();
+        needs_refresh = false;
+    }
+    if (telemetry != nullptr) {
+        telemetry->input_end();
     }
 }
 
@@ -101,23 +295,46 @@ bool App::handle_keystroke(int key)
                 ++cursor_x;
             }
             break;
+        case 'n':  // jump to next unresolved cell
+        case 'p':  // jump to previous unresolved cell
+            if (const auto cell = board.find_unresolved(cursor_y, cursor_x, key == 'n'); cell.has_value()) {
+                cursor_y = cell->first;
+                cursor_x = cell->second;
+            }
+            break;
         case 'f':  // flag
-            if (board.toggle_flag(cursor_y, cursor_x) == 0) {
-                refresh();
+            if (coop != nullptr) {
+                // the server sends back the change
+                coop->toggle_flag(cursor_y, cursor_x);
+            } else if (board.toggle_flag(cursor_y, cursor_x) == 0) {
+                record(ReplayEvent::Action::flag);
+                needs_refresh = true;
             }
             break;
         case ' ':  // open
-            if (board.click_cell(cursor_y, cursor_x) == 0) {
-                refresh();
+            if (coop != nullptr) {
+                coop->click_cell(cursor_y, cursor_x);
+            } else if (board.click_cell(cursor_y, cursor_x) == 0) {
+                record(ReplayEvent::Action::click);
+                needs_refresh = true;
             }
             break;
         case 'z':  // new game
+            if (coop != nullptr) {
+                coop->new_game();
+                break;
+            }
             board.reset();
-            refresh();
+            record(ReplayEvent::Action::reset);
+            needs_refresh = true;
+            break;
+        case '?':  // hint
+            request_hint();
             break;
         case 'r':  // refresh
             clearok(curscr, true);
-            refresh();
+            board.redraw();
+            needs_refresh = true;
             break;
         case 'q':  // quit
             return false;
@@ -125,4 +342,55 @@ bool App::handle_keystroke(int key)
     return true;
 }
 
+void App::request_hint()
+{
+    if (board.get_state() != Game::State::active) {
+        return;
+    }
+    if (!hinter.has_value()) {
+        hinter.emplace(board.rows, board.cols, board.mines, hint_budget);
+    }
+    hinter->request(board, cursor_y, cursor_x);
+}
+
+void App::show_hint()
+{
+    const std::optional<Hint> hint = hinter->take();
+    if (!hint.has_value() || hint->hash != board.get_hash()) {
+        // not ready, or the board changed since the hint was asked for
+        return;
+    }
+    board.show_hint(hint->row, hint->col, hint->safe);
+    cursor_y = hint->row;
+    cursor_x = hint->col;
+    refresh();
+}
+
+bool App::is_hint_pending()
+{
+    return hinter.has_value() && hinter->is_pending();
+}
+
+void App::record(ReplayEvent::Action action)
+{
+    if (!recorder.has_value()) {
+        return;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now() - start_time);
+    recorder->write({
+        .time_ms = static_cast<uint64_t>(elapsed.count()),
+        .action = action,
+        .row = cursor_y,
+        .col = cursor_x,
+        .seed = board.get_seed(),
+    });
+}
+
+void App::autosave()
+{
+    if (autosaver != nullptr) {
+        autosaver->submit(board);
+    }
+}
+
 }  // namespace ngames::mines
@@ -1,12 +1,23 @@
 #pragma once
 
+#include <ngames/mines/autosave.hpp>
 #include <ngames/mines/board.hpp>
+#include <ngames/mines/coop_client.hpp>
+#include <ngames/mines/hinter.hpp>
+#include <ngames/mines/minimap.hpp>
+#include <ngames/mines/replay.hpp>
+#include <ngames/mines/telemetry.hpp>
 #include <ngames/mines/text_end_game.hpp>
 #include <ngames/mines/text_instructions.hpp>
 #include <ngames/mines/text_mine_count.hpp>
 
 #include <ngames/common/border.hpp>
 
+#include <chrono>
+#include <optional>
+
+#include <cstdio>
+
 
 namespace ngames::mines
 {
@@ -21,26 +32,82 @@ public:
     static constexpr int MARGIN_TOP = 1;
     // Left margin, in number of chars
     static constexpr int MARGIN_LEFT = 1;
+    // Time between checks for a finished hint while it is computed, in
+    // milliseconds
+    static constexpr int HINT_POLL_MS = 5;
 
     /**
      * Create application.
      * @param rows Number of rows for the Minesweeper board.
      * @param cols Number of columns for the Minesweeper board.
      * @param mines Number of mines for the Minesweeper board.
+     * @param record_file If not null, the session is recorded to this file.
+     * @param autosaver If not null, the game is saved with this after every
+     * batch of input events that changed it.
+     * @param coop If not null, the board is played on this co-op server instead.
+     * @param telemetry If not null, the timings of input events are recorded to this.
+     * @param snapshot If not null, the saved game to restore, with the same
+     * size as the board, instead of starting a new one.
+     * @param seed Seed of the first game, or a new random seed if none.
      */
-    App(int rows, int cols, int mines);
+    App(int rows,
+        int cols,
+        int mines,
+        FILE* record_file = nullptr,
+        Autosaver* autosaver = nullptr,
+        CoopClient* coop = nullptr,
+        Telemetry* telemetry = nullptr,
+        const Snapshot* snapshot = nullptr,
+        std::optional<unsigned> seed = std::nullopt);
 
     /**
      * Run the application.
      */
     void run();
 
+    /**
+     * Set the time budget of hints, after which the best hint found so far
+     * is shown.
+     * @param budget Time budget.
+     */
+    void set_hint_budget(std::chrono::milliseconds budget);
+
+    /**
+     * Play back a recorded session on the board, which must have been created
+     * with the seed of the first recorded game. Returns once all events have
+     * been played, or the user quits.
+     * @param reader Reader whose header has already been read.
+     * @param speed Playback speed relative to real time. If zero, play back as
+     * fast as possible.
+     */
+    void replay(ReplayReader& reader, double speed);
+
 private:
     /**
      * Refresh the windows of the application.
      */
     void refresh() const;
 
+    /**
+     * Run the application on a co-op server, applying changes from the server
+     * as they arrive.
+     */
+    void run_coop();
+
+    /**
+     * Perform action associated with given keystroke or mouse event, timing
+     * it if measuring. The windows are only refreshed by `end_batch()`.
+     * @param key Key pressed.
+     * @returns False when we want to quit.
+     */
+    bool handle_input(int key);
+
+    /**
+     * Refresh the windows once after handling a batch of input events, if
+     * they changed.
+     */
+    void end_batch();
+
     /**
      * Perform action associated with given keystroke or mouse event.
      * @param key Key pressed.
@@ -48,6 +115,34 @@ private:
      */
     bool handle_keystroke(int key);
 
+    /**
+     * Start computing a hint for the board in the background.
+     */
+    void request_hint();
+
+    /**
+     * Highlight the requested hint and move the cursor to it, if it is ready
+     * and the board did not change meanwhile.
+     */
+    void show_hint();
+
+    /**
+     * Returns true if a hint is being computed.
+     */
+    bool is_hint_pending();
+
+    /**
+     * Record an action at the cursor, if recording.
+     * @param action Action.
+     */
+    void record(ReplayEvent::Action action);
+
+    /**
+     * Save the cells of the game changed since the last refresh, if
+     * autosaving.
+     */
+    void autosave();
+
     // y-coordinate of cursor, relative to board window.
     int cursor_y;
     // x-coordinate of cursor, relative to board window.
@@ -58,6 +153,27 @@ private:
     Board board;
     TextEndGame text_end_game;
     TextInstructions text_instructions;
+    // Only created for boards that are larger than the minimap.
+    std::optional<Border> minimap_border;
+    std::optional<Minimap> minimap;
+
+    // Computes hints in the background; only created once a hint is asked
+    // for.
+    std::optional<Hinter> hinter;
+    std::chrono::milliseconds hint_budget;
+    // Whether the windows changed since they were last refreshed.
+    bool needs_refresh;
+
+    // Session recorder, if recording.
+    std::optional<ReplayWriter> recorder;
+    // Saves the game in the background, if autosaving.
+    Autosaver* const autosaver;
+    // Connection to the co-op server, if playing co-op.
+    CoopClient* const coop;
+    // Timings of input events, if measuring.
+    Telemetry* const telemetry;
+    // Time the application was created.
+    std::chrono::steady_clock::time_point start_time;
 };
 
 }  // namespace ngames::mines
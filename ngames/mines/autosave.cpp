@@ -0,0 +1,396 @@
+#include <ngames/mines/autosave.hpp>
+
+#include <algorithm>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+constexpr char MAGIC[4] = {'M', 'N', 'S', 'V'};
+constexpr uint32_t VERSION = 1;
+
+constexpr int NUM_SLOTS = 2;
+
+/**
+ * Header at the start of the file.
+ */
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t rows;
+    int32_t cols;
+    int32_t mines;
+    uint32_t padding;
+};
+
+/**
+ * Header of a slot. The slot's cells are stored after all slot headers.
+ */
+struct SlotHeader {
+    // Sequence number of the snapshot, or 0 if the slot is empty.
+    uint64_t sequence;
+    // Checksum over all other fields and the slot's cells.
+    uint64_t checksum;
+    uint32_t seed;
+    // (row, column) of first opened cell, or -1 if none.
+    int32_t first_row;
+    int32_t first_col;
+    uint32_t padding;
+};
+
+inline size_t slot_header_offset(int slot)
+{
+    return sizeof(FileHeader) + slot * sizeof(SlotHeader);
+}
+
+inline size_t cells_offset(int slot, size_t num_cells)
+{
+    return sizeof(FileHeader) + NUM_SLOTS * sizeof(SlotHeader) + slot * num_cells;
+}
+
+inline size_t file_size(size_t num_cells)
+{
+    return cells_offset(NUM_SLOTS, num_cells);
+}
+
+/**
+ * 64-bit FNV-1a hash of a byte array.
+ * @param data Byte array.
+ * @param size Number of bytes.
+ * @param hash Hash of any previous data, for hashing in parts.
+ */
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3;
+    }
+    return hash;
+}
+
+/**
+ * Compute the checksum of a slot.
+ * @param header Slot header; its `checksum` field is ignored.
+ * @param cells Slot cells.
+ * @param num_cells Number of cells.
+ */
+uint64_t slot_checksum(const SlotHeader& header, const void* cells, size_t num_cells)
+{
+    SlotHeader fields = header;
+    fields.checksum = 0;
+    return fnv1a(cells, num_cells, fnv1a(&fields, sizeof(fields)));
+}
+
+/**
+ * Find the latest valid slot of a file.
+ * @param mapping Mapped file, with a valid file header.
+ * @param header File header.
+ * @param best_header Set to the header of the latest valid slot, if any.
+ * @returns Index of the latest valid slot, or -1 if there is none.
+ */
+int find_latest_slot(const std::byte* mapping, const FileHeader& header, SlotHeader& best_header)
+{
+    const size_t num_cells = static_cast<size_t>(header.rows) * header.cols;
+    int best_slot = -1;
+    best_header = {};
+    for (int slot = 0; slot < NUM_SLOTS; ++slot) {
+        SlotHeader slot_header;
+        std::memcpy(&slot_header, mapping + slot_header_offset(slot), sizeof(slot_header));
+        if (slot_header.sequence == 0 || slot_header.sequence <= best_header.sequence) {
+            continue;
+        }
+        if (slot_header.first_row >= header.rows || slot_header.first_col >= header.cols) {
+            continue;
+        }
+        if (slot_header.checksum != slot_checksum(slot_header, mapping + cells_offset(slot, num_cells), num_cells)) {
+            continue;
+        }
+        best_slot = slot;
+        best_header = slot_header;
+    }
+    return best_slot;
+}
+
+/**
+ * Map a file of snapshots to memory.
+ * @param path Path to file.
+ * @param header Header of the file.
+ * @param create If true, the file is created, or replaced, with empty slots.
+ * Otherwise, the file must exist with the same header.
+ * @param sequence Set to the sequence number of the latest valid snapshot of
+ * the file, or 0 if there is none.
+ * @returns Mapped file, or null if an error occurred.
+ */
+std::byte* map_file(const char* path, const FileHeader& header, bool create, uint64_t& sequence)
+{
+    const size_t mapping_size = file_size(static_cast<size_t>(header.rows) * header.cols);
+    const int fd = create ? ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path, O_RDWR);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (create ? ftruncate(fd, mapping_size) == 0
+               : fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == mapping_size) {
+        addr = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    auto* mapping = static_cast<std::byte*>(addr);
+
+    if (create) {
+        // file is zero-filled, so both slots start out empty
+        std::memcpy(mapping, &header, sizeof(header));
+        sequence = 0;
+    } else {
+        // only keep a file for a game of the same size, continuing its sequence
+        if (std::memcmp(mapping, &header, sizeof(header)) != 0) {
+            munmap(addr, mapping_size);
+            return nullptr;
+        }
+        SlotHeader latest;
+        find_latest_slot(mapping, header, latest);
+        sequence = latest.sequence;
+    }
+    return mapping;
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+Autosaver::Autosaver(const char* path, int rows, int cols, int mines)
+    : mapping(nullptr),
+      mapping_size(file_size(static_cast<size_t>(rows) * cols)),
+      sequence(0),
+      // NOTE: a game has been reset once it is created, so the first
+      // submission takes all of its cells
+      submitted_resets(0),
+      full(false),
+      pending(false),
+      stopping(false)
+{
+    const FileHeader header = {
+        .magic = {MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]},
+        .version = VERSION,
+        .rows = rows,
+        .cols = cols,
+        .mines = mines,
+        .padding = 0,
+    };
+    // NOTE: the file is never truncated, so that its latest snapshot is only
+    // lost once a newer one is written. A file for a game of the same size is
+    // written in place, into the older slot first; any other file is replaced
+    // by a new one once it holds a snapshot
+    mapping = map_file(path, header, false, sequence);
+    if (mapping == nullptr) {
+        replaced_path = path;
+        temp_path = replaced_path + ".tmp";
+        mapping = map_file(temp_path.c_str(), header, true, sequence);
+        if (mapping == nullptr) {
+            return;
+        }
+    }
+
+    staging = {
+        .rows = rows,
+        .cols = cols,
+        .mines = mines,
+        .seed = 0,
+        .first_opened = std::nullopt,
+        .cells = std::vector<Cell>(static_cast<size_t>(rows) * cols),
+    };
+    writing = staging;
+    thread = std::thread(&Autosaver::write_loop, this);
+}
+
+Autosaver::~Autosaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (mapping != nullptr) {
+        msync(mapping, mapping_size, MS_SYNC);
+        munmap(mapping, mapping_size);
+    }
+    // a new file that never held a snapshot leaves the old one in place
+    if (!temp_path.empty()) {
+        unlink(temp_path.c_str());
+    }
+}
+
+void Autosaver::submit(const Game& game)
+{
+    if (!is_open()) {
+        return;
+    }
+    assert(game.get_cells().size() == staging.cells.size());  // game must have the same size
+
+    const auto& cells = game.get_cells();
+    const auto& changes = game.get_changes();
+    const bool reset = game.get_num_resets() != submitted_resets;
+    if (!reset && changes.empty()) {
+        return;
+    }
+    submitted_resets = game.get_num_resets();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        staging.seed = game.get_seed();
+        staging.first_opened = game.get_first_opened();
+        // NOTE: once the changes take as much memory as the cells, taking all
+        // cells bounds the memory kept until the next write, and costs about
+        // as much as taking the changes did
+        if (reset || (!full && (updates.size() + changes.size()) * sizeof(updates[0]) > cells.size())) {
+            std::copy(cells.begin(), cells.end(), staging.cells.begin());
+            updates.clear();
+            full = true;
+        } else if (full) {
+            for (const int idx : changes) {
+                staging.cells[idx] = cells[idx];
+            }
+        } else {
+            for (const int idx : changes) {
+                updates.emplace_back(idx, cells[idx]);
+            }
+        }
+        pending = true;
+    }
+    cv.notify_one();
+}
+
+void Autosaver::write_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return pending || stopping; });
+        if (!pending) {
+            break;
+        }
+
+        // take the pending changes, so that the game can submit more while we
+        // write these
+        writing.seed = staging.seed;
+        writing.first_opened = staging.first_opened;
+        if (full) {
+            // NOTE: `staging` only holds cells when `full`, so it can take
+            // the outdated ones
+            std::swap(staging.cells, writing.cells);
+            full = false;
+        }
+        std::swap(updates, taken_updates);
+        pending = false;
+
+        lock.unlock();
+        for (const auto& [idx, cell] : taken_updates) {
+            writing.cells[idx] = cell;
+        }
+        taken_updates.clear();
+        write_slot(writing);
+        lock.lock();
+
+        // limit how often we write
+        cv.wait_for(lock, WRITE_INTERVAL, [this] { return stopping; });
+    }
+}
+
+void Autosaver::write_slot(const Snapshot& snapshot)
+{
+    const uint64_t next_sequence = sequence + 1;
+    const int slot = next_sequence % NUM_SLOTS;
+    const size_t num_cells = snapshot.cells.size();
+
+    // write cells first; the header is only valid once its checksum matches them
+    std::byte* cells = mapping + cells_offset(slot, num_cells);
+    std::memcpy(cells, snapshot.cells.data(), num_cells);
+
+    SlotHeader header = {
+        .sequence = next_sequence,
+        .checksum = 0,
+        .seed = snapshot.seed,
+        .first_row = snapshot.first_opened.has_value() ? snapshot.first_opened->first : -1,
+        .first_col = snapshot.first_opened.has_value() ? snapshot.first_opened->second : -1,
+        .padding = 0,
+    };
+    header.checksum = slot_checksum(header, cells, num_cells);
+    std::memcpy(mapping + slot_header_offset(slot), &header, sizeof(header));
+
+    sequence = next_sequence;
+
+    // a new file replaces the old one once its first snapshot is on disk
+    if (!temp_path.empty()) {
+        if (msync(mapping, mapping_size, MS_SYNC) == 0 && rename(temp_path.c_str(), replaced_path.c_str()) == 0) {
+            temp_path.clear();
+        }
+        return;
+    }
+    // schedule write-back without waiting for it
+    msync(mapping, mapping_size, MS_ASYNC);
+}
+
+bool Autosaver::load(const char* path, Snapshot& snapshot)
+{
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(FileHeader)) {
+        addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    const auto* mapping = static_cast<const std::byte*>(addr);
+
+    // check file header
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const size_t num_cells = static_cast<size_t>(header.rows) * header.cols;
+    const bool valid_header = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                              header.rows > 0 && header.cols > 0 &&
+                              static_cast<size_t>(st.st_size) == file_size(num_cells);
+
+    SlotHeader best_header;
+    const int best_slot = valid_header ? find_latest_slot(mapping, header, best_header) : -1;
+
+    if (best_slot >= 0) {
+        const auto* cells = reinterpret_cast<const Cell*>(mapping + cells_offset(best_slot, num_cells));
+        snapshot = {
+            .rows = header.rows,
+            .cols = header.cols,
+            .mines = header.mines,
+            .seed = best_header.seed,
+            .first_opened = std::nullopt,
+            .cells = std::vector<Cell>(cells, cells + num_cells),
+        };
+        if (best_header.first_row >= 0) {
+            snapshot.first_opened = {best_header.first_row, best_header.first_col};
+        }
+    }
+    munmap(addr, st.st_size);
+    return best_slot >= 0;
+}
+
+}  // namespace ngames::mines
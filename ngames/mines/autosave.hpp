@@ -0,0 +1,153 @@
+#pragma once
+
+#include <ngames/mines/cell.hpp>
+#include <ngames/mines/game.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Everything needed to restore a game in progress.
+ */
+struct Snapshot {
+    int rows;
+    int cols;
+    int mines;
+    // Seed used to place the mines.
+    unsigned seed;
+    // (row, column) of first opened cell, if any.
+    std::optional<std::pair<int, int>> first_opened;
+    // Packed cells in reading order.
+    std::vector<Cell> cells;
+};
+
+/**
+ * Periodically saves snapshots of a game to a memory-mapped file from a
+ * background thread, so that a game is not lost if the terminal dies.
+ *
+ * The game hands over the cells that changed since its last submission, and
+ * the background thread applies them to its own copy of the game before
+ * writing it, so a move only costs in proportion to the cells it changed.
+ *
+ * The file holds two slots, each with its own header followed by the packed
+ * cells of the game. Snapshots alternate between the slots, and each header
+ * holds a sequence number and a checksum over the slot. When loading, the
+ * valid slot with the highest sequence number is used, so a torn write is
+ * detected and only loses the latest snapshot.
+ *
+ * The file is never truncated in place: a file holding snapshots of a game of
+ * the same size is written to in turn, and any other file is only replaced
+ * once a new file holds a snapshot, so the last game saved survives until a
+ * newer snapshot is written.
+ */
+class Autosaver
+{
+public:
+    // Minimum time between writes to the file.
+    static constexpr std::chrono::milliseconds WRITE_INTERVAL{1000};
+
+    /**
+     * Open or create the file, mapping it to memory, and start the background
+     * thread. Check `is_open()` for success.
+     * @param path Path to file. Any existing file is replaced once the first
+     * snapshot is written, or continued if it is for a game of the same size.
+     * @param rows Number of rows of the game.
+     * @param cols Number of columns of the game.
+     * @param mines Number of mines of the game.
+     */
+    Autosaver(const char* path, int rows, int cols, int mines);
+
+    /**
+     * Write any pending snapshot, and then close the file.
+     */
+    ~Autosaver();
+
+    Autosaver(const Autosaver&) = delete;
+    Autosaver& operator=(const Autosaver&) = delete;
+
+    /**
+     * Returns true if the file was successfully created.
+     */
+    inline bool is_open() const { return mapping != nullptr; }
+
+    /**
+     * Take the changes of a game since the last submission, to be written by
+     * the background thread. Only copies the changed cells, or all cells once
+     * the game was reset, and never waits for I/O.
+     * @param game Game, with the same size as given to the constructor,
+     * tracking its changed cells, which must not have been cleared since the
+     * last submission unless the game was reset.
+     */
+    void submit(const Game& game);
+
+    /**
+     * Load the latest valid snapshot from a file.
+     * @param path Path to file.
+     * @param snapshot Set to the snapshot.
+     * @returns False if the file could not be read, or holds no valid snapshot.
+     */
+    static bool load(const char* path, Snapshot& snapshot);
+
+private:
+    /**
+     * Body of the background thread. Writes pending snapshots, at most once
+     * every `WRITE_INTERVAL`, until stopped.
+     */
+    void write_loop();
+
+    /**
+     * Write a snapshot into the older of the two slots.
+     * @param snapshot Snapshot.
+     */
+    void write_slot(const Snapshot& snapshot);
+
+    // Memory-mapped file.
+    std::byte* mapping;
+    size_t mapping_size;
+    // Sequence number of the last snapshot written.
+    uint64_t sequence;
+    // Path of a new file that replaces `replaced_path` once it holds a
+    // snapshot, or empty if the file is written in place.
+    std::string temp_path;
+    std::string replaced_path;
+
+    // Number of resets of the game when last submitted, to tell when all
+    // its cells must be taken again.
+    uint64_t submitted_resets;
+
+    // Guards `staging`, `updates`, `full`, `pending` and `stopping`.
+    std::mutex mutex;
+    std::condition_variable cv;
+    // Latest seed and first opened cell of the game, and all of its cells if
+    // `full`.
+    Snapshot staging;
+    // Cells (index, state) changed since the background thread last took the
+    // changes, unless `full`.
+    std::vector<std::pair<int, Cell>> updates;
+    // Whether `staging` holds all cells of the game.
+    bool full;
+    // Whether there are changes that have not been written yet.
+    bool pending;
+    // Whether the background thread should exit.
+    bool stopping;
+
+    // Game as last taken by the background thread, being written.
+    Snapshot writing;
+    // Changed cells taken by the background thread, kept to avoid allocating.
+    std::vector<std::pair<int, Cell>> taken_updates;
+
+    std::thread thread;
+};
+
+}  // namespace ngames::mines
@@ -1,216 +1,157 @@
 #include <ngames/mines/board.hpp>
 
-#include <ngames/mines/neighbors.hpp>
 #include <ngames/mines/ui.hpp>
 
-#include <algorithm>
+#include <array>
 
-#include <cassert>
 
-
-namespace ngames::mines
+namespace
 {
 
-Board::Board(int rows, int cols, int mines, int start_y, int start_x, WINDOW* border_window)
-    : Component(subwin(border_window, rows, cols, start_y, start_x)),
-      rows(rows),
-      cols(cols),
-      mines(mines),
-      game(rows, cols, mines)
+/**
+ * Return the glyph of a cell, with its attributes.
+ * @param cell Packed cell.
+ * @param ended Whether the game has ended.
+ */
+constexpr chtype cell_glyph(ngames::mines::Cell cell, bool ended)
 {
-    // create empty data structures
-    is_known_mine_array.reserve(rows);
-    is_opened_array.reserve(rows);
-    is_flagged_array.reserve(rows);
-    neighbor_mine_counts.reserve(rows);
-    for (int i = 0; i < rows; ++i) {
-        is_known_mine_array.emplace_back(cols);
-        is_opened_array.emplace_back(cols);
-        is_flagged_array.emplace_back(cols);
-        neighbor_mine_counts.emplace_back(cols);
+    using namespace ngames::mines;
+    if (cell & CELL_FLAGGED) {
+        // if game ended and flag is incorrect, use red background and blink
+        if (ended && !(cell & CELL_KNOWN_MINE)) {
+            return 'F' | A_BOLD | A_BLINK | COLOR_PAIR(COLOR_PAIR_MISTAKE);
+        }
+        return 'F' | A_BOLD;
     }
-
-    reset();
-}
-
-void Board::reset()
-{
-    // reset the game
-    game.reset();
-
-    // initialize data
-    state = State::active;
-    num_opened = 0;
-    num_flags = 0;
-    last_opened = std::nullopt;
-
-    // initialize arrays
-    for (int i = 0; i < rows; ++i) {
-        std::fill(is_known_mine_array[i].begin(), is_known_mine_array[i].end(), false);
-        std::fill(is_opened_array[i].begin(), is_opened_array[i].end(), false);
-        std::fill(is_flagged_array[i].begin(), is_flagged_array[i].end(), false);
-        std::fill(neighbor_mine_counts[i].begin(), neighbor_mine_counts[i].end(), UNSET_NEIGHBOR_MINE_COUNT);
+    if (cell & CELL_KNOWN_MINE) {
+        return '*' | A_BOLD;
+    }
+    if (!(cell & CELL_OPENED)) {
+        return '#' | COLOR_PAIR(COLOR_PAIR_UNOPENED);
+    }
+    // otherwise, empty cell. print number of neighboring mines, or blank over
+    // what was drawn before
+    const int neighbor_mines = cell & CELL_COUNT_MASK;
+    if (neighbor_mines != 0) {
+        return static_cast<chtype>('0' + neighbor_mines) | COLOR_PAIR(neighbor_mines);
     }
+    return ' ';
 }
 
-void Board::refresh() const
-{
-    werase(window);
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
-            print_cell(row, col);
+// Glyph of every packed cell, while the game is active and once it has ended.
+constexpr auto CELL_GLYPHS = [] {
+    std::array<std::array<chtype, 256>, 2> table = {};
+    for (int ended = 0; ended < 2; ++ended) {
+        for (int cell = 0; cell < 256; ++cell) {
+            table[ended][cell] = cell_glyph(static_cast<ngames::mines::Cell>(cell), ended);
         }
     }
-    wnoutrefresh(window);
+    return table;
+}();
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+Board::Board(int rows, int cols, int mines, unsigned seed, int start_y, int start_x, WINDOW* border_window)
+    : Game(rows, cols, mines, seed),
+      Component(subwin(border_window, rows, cols, start_y, start_x)),
+      needs_redraw(true),
+      drawn_resets(0),
+      drawn_state(State::active),
+      row_glyphs(cols)
+{
+    track_changes(true);
 }
 
-void Board::print_cell(int row, int col) const
+void Board::refresh() const
 {
-    wmove(window, row, col);
-    if (is_flagged(row, col)) {
-        auto attr = A_BOLD;
-        // if game ended and flag is incorrect, use red background and blink
-        if (state != State::active && !is_known_mine(row, col)) {
-            attr |= A_BLINK | COLOR_PAIR(COLOR_PAIR_MISTAKE);
+    const std::optional<std::pair<int, int>> hint_cell = visible_hint();
+    if (needs_redraw || drawn_resets != get_num_resets() || drawn_state != get_state()) {
+        for (int row = 0; row < rows; ++row) {
+            print_row(row);
         }
-        wattron(window, attr);
-        waddch(window, 'F');
-        wattroff(window, attr);
-        return;
-    }
-    if (is_known_mine(row, col)) {
-        auto attr = A_BOLD;
-        // if last click, use red background and blink
-        if (last_opened.has_value() && row == last_opened->first && col == last_opened->second) {
-            attr |= A_BLINK | COLOR_PAIR(COLOR_PAIR_MISTAKE);
+    } else {
+        // NOTE: a cell may have changed several times, and is then drawn
+        // several times, which only costs the moves: ncurses only sends the
+        // final state of each cell to the terminal
+        for (const int idx : get_changes()) {
+            print_cell(idx / cols, idx % cols);
+        }
+        if (drawn_hint != hint_cell) {
+            if (drawn_hint.has_value()) {
+                print_cell(drawn_hint->first, drawn_hint->second);
+            }
+            if (hint_cell.has_value()) {
+                print_cell(hint_cell->first, hint_cell->second);
+            }
         }
-        wattron(window, attr);
-        waddch(window, '*');
-        wattroff(window, attr);
-        return;
-    }
-    if (!is_opened(row, col)) {
-        constexpr auto attr = COLOR_PAIR(COLOR_PAIR_UNOPENED);
-        wattron(window, attr);
-        waddch(window, '#');
-        wattroff(window, attr);
-        return;
-    }
-    // otherwise, empty cell. print number of neighboring mines
-    const int neighbor_mines = get_neighbor_mine_count(row, col);
-    if (neighbor_mines != 0) {
-        const char digit = static_cast<char>(neighbor_mines) + '0';
-        const auto attr = COLOR_PAIR(neighbor_mines);
-        wattron(window, attr);
-        waddch(window, digit);
-        wattroff(window, attr);
     }
+    needs_redraw = false;
+    drawn_resets = get_num_resets();
+    clear_changes();
+    drawn_state = get_state();
+    drawn_hint = hint_cell;
+    wnoutrefresh(window);
 }
 
-int Board::click_cell(int row, int col)
+void Board::redraw()
 {
-    if (state != State::active) {
-        return 1;
-    } else if (is_flagged(row, col)) {
-        return 3;
-    } else if (!is_opened(row, col)) {
-        open(row, col);
-    } else if (can_chord(row, col)) {
-        open_neighbors(row, col);
-    } else {
-        return 2;
-    }
-    return 0;
+    needs_redraw = true;
 }
 
-void Board::open(int row, int col)
+void Board::show_hint(int row, int col, bool safe)
 {
-    // interact with backend
-    int neighbor_mine_count = UNSET_NEIGHBOR_MINE_COUNT;  // this is set if `is_mine` is false
-    const bool is_mine = game.open(row, col, neighbor_mine_count);
-
-    // update state
-    is_opened_array[row][col] = true;
-    ++num_opened;
-    last_opened = {row, col};
-
-    // check if lost
-    if (is_mine) {
-        state = State::lose;
-        populate_known_mine_array();
-        return;
-    }
-
-    assert(neighbor_mine_count != UNSET_NEIGHBOR_MINE_COUNT);
-    neighbor_mine_counts[row][col] = neighbor_mine_count;
-
-    if (check_win()) {
-        state = State::win;
-        populate_known_mine_array();
-        return;
-    }
-
-    // if no neighboring mines, recursively open all neighboring cells
-    if (neighbor_mine_count == 0) {
-        open_neighbors(row, col);
-    }
+    hint = HintCell{.row = row, .col = col, .safe = safe, .hash = get_hash()};
 }
 
-void Board::open_neighbors(int row, int col)
+std::optional<std::pair<int, int>> Board::visible_hint() const
 {
-    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
-        if (can_open(nb_row, nb_col)) {
-            open(nb_row, nb_col);
-        }
+    if (!hint.has_value() || hint->hash != get_hash()) {
+        return std::nullopt;
     }
+    return std::make_pair(hint->row, hint->col);
 }
 
-int Board::toggle_flag(int row, int col)
+chtype Board::glyph_at(int row, int col) const
 {
-    if (state != State::active) {
-        return 1;
-    } else if (is_opened(row, col)) {
-        return 2;
-    }
-
-    if (is_flagged_array[row][col]) {
-        is_flagged_array[row][col] = false;
-        --num_flags;
-    } else {
-        is_flagged_array[row][col] = true;
-        ++num_flags;
-    }
-    return 0;
+    const Cell cell = get_cell(row, col);
+    return CELL_GLYPHS[get_state() != State::active][cell];
 }
 
-int Board::count_neighbor_flags(int row, int col) const
+void Board::print_cell(int row, int col) const
 {
-    int count = 0;
-    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
-        if (is_flagged(nb_row, nb_col)) {
-            ++count;
-        }
-    }
-    return count;
+    chtype glyph = glyph_at(row, col);
+    apply_highlights(row, col, col + 1, &glyph);
+    mvwaddch(window, row, col, glyph);
 }
 
-int Board::count_neighbor_unopened(int row, int col) const
+void Board::print_row(int row) const
 {
-    int count = 0;
-    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
-        if (!is_opened(nb_row, nb_col)) {
-            ++count;
-        }
+    for (int col = 0; col < cols; ++col) {
+        row_glyphs[col] = glyph_at(row, col);
     }
-    return count;
+    apply_highlights(row, 0, cols, row_glyphs.data());
+    mvwaddchnstr(window, row, 0, row_glyphs.data(), cols);
 }
 
-void Board::populate_known_mine_array()
+void Board::apply_highlights(int row, int start_col, int end_col, chtype* glyphs) const
 {
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
-            is_known_mine_array[row][col] = game.is_mine(row, col);
-        }
+    // if last click opened a mine, use red background and blink
+    const auto& last_opened = get_last_opened();
+    if (last_opened.has_value() && last_opened->first == row && last_opened->second >= start_col &&
+        last_opened->second < end_col && is_known_mine(row, last_opened->second) &&
+        !is_flagged(row, last_opened->second)) {
+        glyphs[last_opened->second - start_col] = '*' | A_BOLD | A_BLINK | COLOR_PAIR(COLOR_PAIR_MISTAKE);
+    }
+    const auto hint_cell = visible_hint();
+    if (hint_cell.has_value() && hint_cell->first == row && hint_cell->second >= start_col &&
+        hint_cell->second < end_col &&
+        (get_cell(row, hint_cell->second) & (CELL_OPENED | CELL_FLAGGED | CELL_KNOWN_MINE)) == 0) {
+        glyphs[hint_cell->second - start_col] =
+            '#' | A_BOLD | COLOR_PAIR(hint->safe ? COLOR_PAIR_HINT_SAFE : COLOR_PAIR_HINT_GUESS);
     }
 }
 
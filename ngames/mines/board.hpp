@@ -1,10 +1,13 @@
 #pragma once
 
-#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/game.hpp>
 
 #include <ngames/common/component.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <utility>
 #include <vector>
 
 
@@ -12,32 +15,28 @@ namespace ngames::mines
 {
 
 /**
- * Front-end for the Minesweeper game. Contains information about the game
- * known by the player, e.g. neighboring mine counts and flags, and maintains
- * the window viewed by the player.
+ * Front-end for the Minesweeper game. Maintains the window viewed by the
+ * player, displaying the game state known by the player.
+ *
+ * Only the cells that changed since the last refresh are redrawn, as read
+ * from the game's changed cells, which each refresh then clears. The whole
+ * board is redrawn after a reset, when the game ends, since that changes how
+ * flags are displayed, or when asked with `redraw()`.
  */
-class Board : public Component
+class Board : public Game, public Component
 {
 public:
-    static constexpr int UNSET_NEIGHBOR_MINE_COUNT = -1;
-
-    enum State { active, win, lose };
-
     /**
      * Create new Minesweeper game.
      * @param rows Number of rows.
      * @param cols Number of columns.
      * @param mines Number of mines.
+     * @param seed Seed determining the locations of the mines.
      * @param start_y y-coordinate of the top-left corner of the window.
      * @param start_x x-coordinate of the top-left corner of the window.
      * @param border_window Parent window containing border.
      */
-    Board(int rows, int cols, int mines, int start_y, int start_x, WINDOW* border_window);
-
-    /**
-     * Reset the game.
-     */
-    void reset();
+    Board(int rows, int cols, int mines, unsigned seed, int start_y, int start_x, WINDOW* border_window);
 
     /**
      * Refresh the window displaying the board.
@@ -45,145 +44,81 @@ public:
     void refresh() const override;
 
     /**
-     * Click on a cell.
-     *
-     * If the cell is unopened, the cell will be opened. If the cell contains a
-     * mine, the game will end. If the cell has no neighboring mines, all
-     * neighboring unopened cells will also be opened (this happens
-     * recursively).
-     *
-     * If the cell has already been opened and the number of neighboring flags
-     * equals the number of neighboring mines, all neighboring unopened cells
-     * will be opened (this happens recursively). This is called "chording".
-     *
-     * @param row Cell row.
-     * @param col Cell column.
-     *
-     * @returns Return code. A non-zero value means that an error occurred and
-     * the game state was not been changed. The possible error codes are
-     *   1: game is inactive.
-     *   2: cell has already been opened, and cannot be chorded.
-     *   3: cell has been flagged.
+     * Redraw the whole board on the next refresh.
      */
-    int click_cell(int row, int col);
+    void redraw();
 
     /**
-     * Toggle the flag for a cell.
-     *
+     * Highlight a cell as the suggested next cell to open, until the board
+     * changes.
      * @param row Cell row.
      * @param col Cell column.
-     *
-     * @returns Return code. A non-zero value means that an error occurred and
-     * the game state was not been changed. The possible error codes are
-     *   1: game is inactive.
-     *   2: cell has already been opened.
+     * @param safe Whether the cell is certain not to contain a mine.
      */
-    int toggle_flag(int row, int col);
-
-    /**
-     * Returns game state.
-     */
-    inline State get_state() const { return state; }
-
-    /**
-     * Return number of flags used.
-     */
-    inline int get_num_flags() const { return num_flags; }
-
-    const int rows;
-    const int cols;
-    const int mines;
+    void show_hint(int row, int col, bool safe);
 
 private:
     /**
-     * Print the cell at the current cursor location, and then advance the
-     * cursor.
-     * @param row Cell row.
-     * @param col Cell column.
-     */
-    void print_cell(int row, int col) const;
-
-    /**
-     * Returns true if the cell can be opened.
+     * Return the glyph of a cell, with its attributes, as looked up from its
+     * packed state, before highlights.
      * @param row Cell row.
      * @param col Cell column.
      */
-    inline bool can_open(int row, int col) const
-    {
-        return state == State::active && !is_opened(row, col) && !is_flagged(row, col);
-    }
+    chtype glyph_at(int row, int col) const;
 
     /**
-     * Returns true if the cell can be chorded.
+     * Print a cell.
      * @param row Cell row.
      * @param col Cell column.
      */
-    inline bool can_chord(int row, int col) const
-    {
-        return state == State::active && is_opened(row, col) && count_neighbor_unopened(row, col) > 0 &&
-               get_neighbor_mine_count(row, col) == count_neighbor_flags(row, col);
-    }
+    void print_cell(int row, int col) const;
 
     /**
-     * Open an unopened cell. If the cell contains a mine, the game will end.
-     * If the cell has no neighboring mines, all neighboring unopened cells
-     * will also be opened (this happens recursively).
+     * Print a row of cells at once.
      * @param row Cell row.
-     * @param col Cell column.
      */
-    void open(int row, int col);
+    void print_row(int row) const;
 
     /**
-     * Open all neighboring unopened cells. See `open()` for more details.
-     * @param row Cell row.
-     * @param col Cell column.
+     * Highlight the last opened cell if it is a mine, and the hinted cell, if
+     * they are in a range of glyphs.
+     * @param row Row of the glyphs.
+     * @param start_col Column of the first glyph.
+     * @param end_col Column after the last glyph.
+     * @param glyphs Glyphs of the range.
      */
-    void open_neighbors(int row, int col);
-
-    inline bool is_known_mine(int row, int col) const { return is_known_mine_array[row][col]; }
-
-    inline bool is_opened(int row, int col) const { return is_opened_array[row][col]; }
-
-    inline bool is_flagged(int row, int col) const { return is_flagged_array[row][col]; }
-
-    inline int get_neighbor_mine_count(int row, int col) const { return neighbor_mine_counts[row][col]; }
-
-    int count_neighbor_flags(int row, int col) const;
-
-    int count_neighbor_unopened(int row, int col) const;
+    void apply_highlights(int row, int start_col, int end_col, chtype* glyphs) const;
 
     /**
-     * Returns true if player win condition has been met, i.e. all non-mine
-     * cells have been opened.
+     * Suggested next cell to open.
      */
-    inline bool check_win() const { return num_opened + mines == rows * cols; };
+    struct HintCell {
+        int row;
+        int col;
+        bool safe;
+        // Hash of the board when the hint was given; the hint is hidden once
+        // the board no longer has this hash.
+        uint64_t hash;
+    };
 
     /**
-     * Query `game` for locations of all mines. This will error out if the game
-     * is still active.
+     * Return the hinted cell, if it should be displayed.
      */
-    void populate_known_mine_array();
-
-    // Game back-end.
-    Minesweeper game;
-
-    // Whether the game is active.
-    State state;
-    // Number of opened cells.
-    int num_opened;
-    // Number of flags used.
-    int num_flags;
-    // (row, column) of last opened cell.
-    std::optional<std::pair<int, int>> last_opened;
-
-    // Array with shape (rows, cols) tracking which cells are known to contain a mine.
-    std::vector<std::vector<bool>> is_known_mine_array;
-    // Array with shape (rows, cols) tracking which cells have been opened.
-    std::vector<std::vector<bool>> is_opened_array;
-    // Array with shape (rows, cols) tracking which cells have been flagged.
-    std::vector<std::vector<bool>> is_flagged_array;
-    // Array with shape (rows, cols) tracking neighbor mine counts for opened cells.
-    std::vector<std::vector<int>> neighbor_mine_counts;
+    std::optional<std::pair<int, int>> visible_hint() const;
+
+    std::optional<HintCell> hint;
+
+    // What the window displays, so that only what changed since is redrawn.
+    // Whether the whole board must be redrawn.
+    mutable bool needs_redraw;
+    // Number of resets of the game.
+    mutable uint64_t drawn_resets;
+    // State of the game.
+    mutable State drawn_state;
+    // Hinted cell, if any.
+    mutable std::optional<std::pair<int, int>> drawn_hint;
+    // Glyphs of the row being printed.
+    mutable std::vector<chtype> row_glyphs;
 };
 
 }  // namespace ngames::mines
@@ -0,0 +1,265 @@
+#include <ngames/mines/bot_protocol.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <random>
+#include <type_traits>
+
+#include <climits>
+#include <cstdio>
+
+
+namespace
+{
+
+// Most tokens in a command, e.g. `new <rows> <cols> <mines> <seed>`.
+constexpr int MAX_TOKENS = 5;
+
+/**
+ * Return the glyph representing a cell to the player.
+ * @param cell Cell.
+ */
+inline char glyph(ngames::mines::Cell cell)
+{
+    if (cell & ngames::mines::CELL_FLAGGED) {
+        return 'F';
+    }
+    if (cell & ngames::mines::CELL_KNOWN_MINE) {
+        return '*';
+    }
+    if (!(cell & ngames::mines::CELL_OPENED)) {
+        return '#';
+    }
+    return static_cast<char>('0' + (cell & ngames::mines::CELL_COUNT_MASK));
+}
+
+/**
+ * Split a string on spaces.
+ * @param str String.
+ * @param tokens Set to the tokens.
+ * @returns Number of tokens, or -1 if there are more than `MAX_TOKENS`.
+ */
+int split(std::string_view str, std::array<std::string_view, MAX_TOKENS>& tokens)
+{
+    int num_tokens = 0;
+    size_t pos = 0;
+    while (true) {
+        pos = str.find_first_not_of(" \t\r", pos);
+        if (pos == std::string_view::npos) {
+            return num_tokens;
+        }
+        const size_t end = std::min(str.find_first_of(" \t\r", pos), str.size());
+        if (num_tokens == MAX_TOKENS) {
+            return -1;
+        }
+        tokens[num_tokens++] = str.substr(pos, end - pos);
+        pos = end;
+    }
+}
+
+/**
+ * Parse a non-negative integer.
+ * @param token String to parse.
+ * @param value Set to the integer.
+ * @returns False if the string is not a non-negative integer.
+ */
+template <typename T>
+bool parse(std::string_view token, T& value)
+{
+    const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (ec != std::errc() || ptr != token.data() + token.size()) {
+        return false;
+    }
+    if constexpr (std::is_signed_v<T>) {
+        return value >= 0;
+    }
+    return true;
+}
+
+/**
+ * Empty a buffer, and drop its room if it grew beyond a limit.
+ * @param buffer String or vector.
+ * @param max_kept Most elements to keep room for.
+ */
+template <typename T>
+void clear_buffer(T& buffer, size_t max_kept)
+{
+    buffer.clear();
+    if (buffer.capacity() > max_kept) {
+        buffer.shrink_to_fit();
+    }
+}
+
+const char* state_name(const ngames::mines::Game* game)
+{
+    if (game == nullptr) {
+        return "none";
+    }
+    switch (game->get_state()) {
+        case ngames::mines::Game::State::active:
+            return "active";
+        case ngames::mines::Game::State::win:
+            return "win";
+        case ngames::mines::Game::State::lose:
+            return "lose";
+    }
+    return "none";
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+BotProtocol::BotProtocol(bool allow_new, std::pmr::memory_resource* memory)
+    : allow_new(allow_new), memory(memory), errors(memory), board(memory), changes(memory)
+{
+}
+
+void BotProtocol::handle(std::string_view line, std::string& reply)
+{
+    clear_buffer(errors, MAX_KEPT_BUFFER);
+    clear_buffer(board, MAX_KEPT_BUFFER);
+    int index = 0;
+    size_t pos = 0;
+    while (pos <= line.size()) {
+        const size_t end = std::min(line.find(';', pos), line.size());
+        const std::string_view command = line.substr(pos, end - pos);
+        pos = end + 1;
+
+        // ignore empty commands, e.g. from a trailing separator
+        if (command.find_first_not_of(" \t\r") == std::string_view::npos) {
+            continue;
+        }
+        if (const char* reason = handle_command(command); reason != nullptr) {
+            char buffer[16];
+            const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), index);
+            errors += " !";
+            errors.append(buffer, end);
+            errors += ':';
+            errors += reason;
+        }
+        ++index;
+    }
+
+    reply = state_name(get_game());
+    if (game.has_value()) {
+        // only send the latest state of each changed cell
+        changes.assign(game->get_changes().begin(), game->get_changes().end());
+        std::sort(changes.begin(), changes.end());
+        changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+        game->clear_changes();
+
+        char buffer[32];
+        for (const int idx : changes) {
+            const int row = idx / game->cols;
+            const int col = idx % game->cols;
+            const int length = snprintf(buffer, sizeof(buffer), " %d,%d,%c", row, col, glyph(game->get_cell(row, col)));
+            reply.append(buffer, length);
+        }
+        clear_buffer(changes, MAX_KEPT_BUFFER);
+    }
+    reply += errors;
+    reply += board;
+}
+
+void BotProtocol::new_game(int rows, int cols, int mines, unsigned seed, const uint64_t* layout)
+{
+    // reuse the game if possible, to avoid allocating
+    if (!game.has_value() || game->rows != rows || game->cols != cols || game->mines != mines) {
+        game.emplace(rows, cols, mines, seed, layout, memory);
+        game->track_changes(true);
+    } else if (layout != nullptr) {
+        game->reset(seed, layout);
+    } else {
+        game->reset(seed);
+    }
+}
+
+const char* BotProtocol::handle_command(std::string_view command)
+{
+    std::array<std::string_view, MAX_TOKENS> tokens;
+    const int num_tokens = split(command, tokens);
+    if (num_tokens <= 0) {
+        return "syntax";
+    }
+    const std::string_view name = tokens[0];
+
+    if (name == "new") {
+        if (!allow_new) {
+            return "forbidden";
+        }
+        int rows, cols, mines;
+        unsigned seed = 0;
+        if ((num_tokens != 4 && num_tokens != 5) || !parse(tokens[1], rows) || !parse(tokens[2], cols) ||
+            !parse(tokens[3], mines) || (num_tokens == 5 && !parse(tokens[4], seed))) {
+            return "syntax";
+        }
+        // since first cell is always empty, can have at most (rows * cols - 1) mines
+        if (rows < Minesweeper::MIN_ROWS || cols < Minesweeper::MIN_COLS || mines < Minesweeper::MIN_MINES ||
+            static_cast<long>(rows) * cols > INT_MAX || mines > rows * cols - 1) {
+            return "size";
+        }
+        if (num_tokens == 4) {
+            seed = std::random_device()();
+        }
+        new_game(rows, cols, mines, seed);
+        return nullptr;
+    }
+
+    if (name == "state") {
+        if (num_tokens != 1) {
+            return "syntax";
+        }
+        if (!game.has_value()) {
+            return "nogame";
+        }
+        board += " =";
+        for (const Cell cell : game->get_cells()) {
+            board += glyph(cell);
+        }
+        return nullptr;
+    }
+
+    if (name != "open" && name != "chord" && name != "flag") {
+        return "unknown";
+    }
+    int row, col;
+    if (num_tokens != 3 || !parse(tokens[1], row) || !parse(tokens[2], col)) {
+        return "syntax";
+    }
+    if (!game.has_value()) {
+        return "nogame";
+    }
+    if (row >= game->rows || col >= game->cols) {
+        return "range";
+    }
+    if (game->get_state() != Game::State::active) {
+        return "inactive";
+    }
+
+    if (name == "flag") {
+        return game->toggle_flag(row, col) == 0 ? nullptr : "opened";
+    }
+    // `click_cell()` both opens and chords, so check which one was asked for
+    if (name == "open" && game->is_opened(row, col)) {
+        return "opened";
+    }
+    if (name == "chord" && !game->is_opened(row, col)) {
+        return "unopened";
+    }
+    switch (game->click_cell(row, col)) {
+        case 0:
+            return nullptr;
+        case 2:
+            return "unchordable";
+        case 3:
+            return "flagged";
+        default:
+            return "inactive";
+    }
+}
+
+}  // namespace ngames::mines
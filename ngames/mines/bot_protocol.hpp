@@ -0,0 +1,101 @@
+#pragma once
+
+#include <ngames/mines/game.hpp>
+
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Line-oriented text protocol for playing Minesweeper without a terminal,
+ * e.g. by bots written in any language.
+ *
+ * Each request line holds one or more commands separated by ';':
+ *   new <rows> <cols> <mines> [<seed>]   start a new game
+ *   open <row> <col>                     open an unopened cell
+ *   chord <row> <col>                    chord an opened cell
+ *   flag <row> <col>                     toggle the flag on a cell
+ *   state                                send the whole board
+ *
+ * Each request line gets exactly one reply line of space-separated tokens.
+ * The first token is the game state after all commands: `active`, `win`,
+ * `lose`, or `none` if no game has been started. Then follow
+ *   <row>,<col>,<glyph>   for each cell changed by the commands
+ *   !<index>:<reason>     for each command that failed, indexed from 0
+ *   =<glyphs>             for `state`, the glyphs of all cells in reading order
+ * where a glyph is `#` (unopened), `F` (flagged), `*` (mine, revealed when the
+ * game ends) or `0`-`8` (opened, with that many neighboring mines). After a
+ * `new`, all cells are unopened and only changes since then are sent.
+ */
+class BotProtocol
+{
+public:
+    /**
+     * Create protocol handler.
+     * @param allow_new Whether to accept the `new` command. If false, games
+     * are only started by `new_game()`, e.g. by a harness dealing boards.
+     * @param memory Memory resource for the allocations of the games and of
+     * the buffers used to build replies, e.g. an arena. A game is only
+     * reallocated when the board size changes.
+     */
+    BotProtocol(bool allow_new = true, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Handle a request line. Only allocates, from the memory resource, when a
+     * request is larger than any before.
+     * @param line Request line, without the trailing newline.
+     * @param reply Set to the reply line, without the trailing newline.
+     */
+    void handle(std::string_view line, std::string& reply);
+
+    /**
+     * Return the current game, or null if no game has been started.
+     */
+    inline const Game* get_game() const { return game.has_value() ? &*game : nullptr; }
+
+    /**
+     * Start a new game, as if by the `new` command.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     * @param seed Seed determining the locations of the mines.
+     * @param layout Mines placed by `seed`, e.g. from a corpus, which skips
+     * drawing them. See `Game::reset()`.
+     */
+    void new_game(int rows, int cols, int mines, unsigned seed, const uint64_t* layout = nullptr);
+
+private:
+    // Most elements the buffers used to build replies keep room for between
+    // requests.
+    static constexpr size_t MAX_KEPT_BUFFER = 64 * 1024;
+
+    /**
+     * Handle a single command. A `state` command sets `board`.
+     * @param command Command, without separators.
+     * @returns Reason the command failed, or null on success.
+     */
+    const char* handle_command(std::string_view command);
+
+    const bool allow_new;
+    std::pmr::memory_resource* const memory;
+
+    std::optional<Game> game;
+
+    // Buffers used to build a reply, kept between requests to avoid
+    // allocating, unless a large request grew them beyond `MAX_KEPT_BUFFER`.
+    // ` !<index>:<reason>` for each failed command.
+    std::pmr::string errors;
+    // ` =<glyphs>` for each `state` command.
+    std::pmr::string board;
+    // Changed cells, sorted and without duplicates.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::pmr::vector<int> changes;
+};
+
+}  // namespace ngames::mines
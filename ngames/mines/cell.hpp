@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace ngames::mines
+{
+
+/**
+ * State of a cell known by the player, packed into a single byte.
+ *   bits 0-3: number of neighboring mines, once the cell is opened.
+ *   bit 4: cell is opened.
+ *   bit 5: cell is flagged.
+ *   bit 6: cell is known to contain a mine, once the game has ended.
+ */
+using Cell = uint8_t;
+
+constexpr Cell CELL_COUNT_MASK = 0x0f;
+constexpr Cell CELL_OPENED = 0x10;
+constexpr Cell CELL_FLAGGED = 0x20;
+constexpr Cell CELL_KNOWN_MINE = 0x40;
+
+}  // namespace ngames::mines
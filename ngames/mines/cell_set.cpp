@@ -0,0 +1,133 @@
+#include <ngames/mines/cell_set.hpp>
+
+#include <algorithm>
+#include <bit>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+CellSet::CellSet(int size, std::pmr::memory_resource* memory) : size(size), levels(memory)
+{
+    assert(size > 0);
+
+    // add levels until a single word covers the level below
+    int bits = size;
+    do {
+        const int words = (bits + 63) / 64;
+        levels.emplace_back(words);
+        bits = words;
+    } while (bits > 1);
+}
+
+void CellSet::clear()
+{
+    for (auto& level : levels) {
+        std::fill(level.begin(), level.end(), 0);
+    }
+}
+
+void CellSet::insert(int idx)
+{
+    assert(0 <= idx && idx < size);  // index must be valid
+
+    for (auto& level : levels) {
+        uint64_t& word = level[idx >> 6];
+        const bool was_empty = word == 0;
+        word |= uint64_t(1) << (idx & 63);
+        // the level above already marks this word as non-zero
+        if (!was_empty) {
+            break;
+        }
+        idx >>= 6;
+    }
+}
+
+void CellSet::erase(int idx)
+{
+    assert(0 <= idx && idx < size);  // index must be valid
+
+    for (auto& level : levels) {
+        uint64_t& word = level[idx >> 6];
+        word &= ~(uint64_t(1) << (idx & 63));
+        // the level above should keep marking this word as non-zero
+        if (word != 0) {
+            break;
+        }
+        idx >>= 6;
+    }
+}
+
+int CellSet::next(int idx) const
+{
+    if (idx >= size) {
+        return -1;
+    }
+    int64_t pos = std::max(idx, 0);
+
+    // climb until a level has a set bit at or after `pos`
+    int level = 0;
+    while (true) {
+        if (level == static_cast<int>(levels.size())) {
+            return -1;
+        }
+        const int64_t w = pos >> 6;
+        if (w >= static_cast<int64_t>(levels[level].size())) {
+            return -1;
+        }
+        const uint64_t word = levels[level][w] & (~uint64_t(0) << (pos & 63));
+        if (word != 0) {
+            pos = (w << 6) + std::countr_zero(word);
+            break;
+        }
+        // look for the next non-zero word in the level above
+        pos = w + 1;
+        ++level;
+    }
+
+    // descend to the first set bit of each word
+    while (level > 0) {
+        --level;
+        pos = (pos << 6) + std::countr_zero(levels[level][pos]);
+    }
+    return static_cast<int>(pos);
+}
+
+int CellSet::prev(int idx) const
+{
+    if (idx < 0) {
+        return -1;
+    }
+    int64_t pos = std::min(idx, size - 1);
+
+    // climb until a level has a set bit at or before `pos`
+    int level = 0;
+    while (true) {
+        if (level == static_cast<int>(levels.size())) {
+            return -1;
+        }
+        const int64_t w = pos >> 6;
+        const uint64_t word = levels[level][w] & (~uint64_t(0) >> (63 - (pos & 63)));
+        if (word != 0) {
+            pos = (w << 6) + 63 - std::countl_zero(word);
+            break;
+        }
+        // look for the previous non-zero word in the level above
+        if (w == 0) {
+            return -1;
+        }
+        pos = w - 1;
+        ++level;
+    }
+
+    // descend to the last set bit of each word
+    while (level > 0) {
+        --level;
+        pos = (pos << 6) + 63 - std::countl_zero(levels[level][pos]);
+    }
+    return static_cast<int>(pos);
+}
+
+}  // namespace ngames::mines
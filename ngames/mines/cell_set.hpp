@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Ordered set of cell indices in [0, size), stored as a hierarchy of bitsets.
+ * Level 0 has a bit per cell, and each bit of a higher level marks whether a
+ * word of the level below is non-zero. Inserting, erasing, and finding the
+ * next or previous element take O(log_64 size) time, and never allocate.
+ */
+class CellSet
+{
+public:
+    /**
+     * Create empty set.
+     * @param size One past the largest index the set can hold.
+     * @param memory Memory resource for the allocations of the set, e.g. an arena.
+     */
+    CellSet(int size, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Remove all elements.
+     */
+    void clear();
+
+    void insert(int idx);
+
+    void erase(int idx);
+
+    inline bool contains(int idx) const { return (levels[0][idx >> 6] >> (idx & 63)) & 1; }
+
+    inline bool empty() const { return levels.back()[0] == 0; }
+
+    /**
+     * Return the smallest element no less than `idx`, or -1 if there is none.
+     */
+    int next(int idx) const;
+
+    /**
+     * Return the largest element no greater than `idx`, or -1 if there is none.
+     */
+    int prev(int idx) const;
+
+    const int size;
+
+private:
+    std::pmr::vector<std::pmr::vector<uint64_t>> levels;
+};
+
+}  // namespace ngames::mines
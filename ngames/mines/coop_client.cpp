@@ -0,0 +1,132 @@
+#include <ngames/mines/coop_client.hpp>
+
+#include <charconv>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace ngames::mines
+{
+
+CoopClient::CoopClient(const char* path) : rows(0), cols(0), mines(0), fd(-1)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path)) {
+        return;
+    }
+    std::strcpy(address.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    // read the hello line one byte at a time, to leave the rest to `receive()`
+    std::string line;
+    char c;
+    while (read(fd, &c, 1) == 1 && c != '\n') {
+        line += c;
+    }
+    if (sscanf(line.c_str(), "hello %d %d %d", &rows, &cols, &mines) != 3) {
+        rows = 0;
+    }
+}
+
+CoopClient::~CoopClient()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void CoopClient::click_cell(int row, int col)
+{
+    send_command("click " + std::to_string(row) + " " + std::to_string(col) + "\n");
+}
+
+void CoopClient::toggle_flag(int row, int col)
+{
+    send_command("flag " + std::to_string(row) + " " + std::to_string(col) + "\n");
+}
+
+void CoopClient::new_game()
+{
+    send_command("new\n");
+}
+
+void CoopClient::send_command(const std::string& command)
+{
+    // NOTE: a server that went away is noticed by `receive()`
+    send(fd, command.data(), command.size(), MSG_NOSIGNAL);
+}
+
+bool CoopClient::receive(Game& game)
+{
+    char chunk[4096];
+    while (true) {
+        const ssize_t length = recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length <= 0) {
+            return false;
+        }
+        buffer.append(chunk, length);
+    }
+
+    // apply all complete lines
+    size_t begin = 0;
+    size_t end;
+    while ((end = buffer.find('\n', begin)) != std::string::npos) {
+        apply(std::string_view(buffer).substr(begin, end - begin), game);
+        begin = end + 1;
+    }
+    buffer.erase(0, begin);
+    return true;
+}
+
+void CoopClient::apply(std::string_view line, Game& game)
+{
+    if (line == "new") {
+        game.reset();
+        return;
+    }
+    if (!line.starts_with("cells")) {
+        return;
+    }
+
+    // parse ` <idx>:<cell>` pairs
+    const char* ptr = line.data() + 5;
+    const char* end = line.data() + line.size();
+    while (ptr < end && *ptr == ' ') {
+        int idx;
+        int cell;
+        auto result = std::from_chars(ptr + 1, end, idx);
+        if (result.ec != std::errc() || result.ptr == end || *result.ptr != ':') {
+            return;
+        }
+        result = std::from_chars(result.ptr + 1, end, cell);
+        if (result.ec != std::errc() || idx < 0 || idx >= rows * cols) {
+            return;
+        }
+        game.set_cell(idx / cols, idx % cols, static_cast<Cell>(cell));
+        ptr = result.ptr;
+    }
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <ngames/mines/game.hpp>
+
+#include <string>
+#include <string_view>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Connection of a player to a co-op server, see coop_server.hpp.
+ */
+class CoopClient
+{
+public:
+    /**
+     * Connect to a server, and wait for the size of its board. Check
+     * `is_connected()` for success.
+     * @param path Path of the server socket.
+     */
+    CoopClient(const char* path);
+
+    ~CoopClient();
+
+    CoopClient(const CoopClient&) = delete;
+    CoopClient& operator=(const CoopClient&) = delete;
+
+    /**
+     * Returns true if connected to a server that sent the size of its board.
+     */
+    inline bool is_connected() const { return fd >= 0 && rows > 0; }
+
+    /**
+     * Return socket, e.g. to poll for changes.
+     */
+    inline int get_fd() const { return fd; }
+
+    /**
+     * Ask the server to click on a cell.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void click_cell(int row, int col);
+
+    /**
+     * Ask the server to toggle the flag for a cell.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void toggle_flag(int row, int col);
+
+    /**
+     * Ask the server to start a new game.
+     */
+    void new_game();
+
+    /**
+     * Read the changes sent by the server, without waiting, and apply them to
+     * a game.
+     * @param game Game, with the size of the board of the server.
+     * @returns False if the server disconnected.
+     */
+    bool receive(Game& game);
+
+    // Size of the board of the server.
+    int rows;
+    int cols;
+    int mines;
+
+private:
+    /**
+     * Send a command to the server.
+     * @param command Command, including the trailing newline.
+     */
+    void send_command(const std::string& command);
+
+    /**
+     * Apply a single line sent by the server.
+     * @param line Line, without the trailing newline.
+     * @param game Game.
+     */
+    void apply(std::string_view line, Game& game);
+
+    int fd;
+    // Received data not yet applied, i.e. an incomplete line.
+    std::string buffer;
+};
+
+}  // namespace ngames::mines
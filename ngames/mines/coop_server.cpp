@@ -0,0 +1,353 @@
+#include <ngames/mines/coop_server.hpp>
+
+#include <ngames/common/unix_socket.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <utility>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+#include <cassert>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+// Most bytes a player may fall behind on top of the board sent when joining.
+// Players further behind are disconnected, so that one who stops reading
+// never holds back the others, nor grows the server without bound.
+constexpr size_t MAX_BACKLOG = 4 * 1024 * 1024;
+
+/**
+ * Append ` <idx>:<cell>` to a message.
+ * @param message Message.
+ * @param idx Cell index.
+ * @param cell Packed cell.
+ */
+void append_cell(std::string& message, int idx, ngames::mines::Cell cell)
+{
+    char buffer[32];
+    const int length = snprintf(buffer, sizeof(buffer), " %d:%d", idx, cell);
+    message.append(buffer, length);
+}
+
+/**
+ * Parse `<row> <col>` of a cell on the board.
+ * @param args Arguments of a command.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param row Set to the row.
+ * @param col Set to the column.
+ * @returns False if the arguments are not a cell on the board.
+ */
+bool parse_cell(std::string_view args, int rows, int cols, int& row, int& col)
+{
+    const char* begin = args.data();
+    const char* end = args.data() + args.size();
+    auto result = std::from_chars(begin, end, row);
+    if (result.ec != std::errc() || result.ptr == end || *result.ptr != ' ') {
+        return false;
+    }
+    result = std::from_chars(result.ptr + 1, end, col);
+    if (result.ec != std::errc() || result.ptr != end) {
+        return false;
+    }
+    return 0 <= row && row < rows && 0 <= col && col < cols;
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+CoopServer::CoopServer(int rows, int cols, int mines)
+    : board(rows, cols, mines), wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), stopping(false)
+{
+    board.reset(std::random_device()());
+    if (wake_fd >= 0) {
+        broadcaster = std::thread(&CoopServer::broadcast_loop, this);
+    }
+}
+
+CoopServer::~CoopServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        // wake up the player threads blocked on reading; the broadcast thread
+        // joins them as they leave
+        for (const int fd : players) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    if (broadcaster.joinable()) {
+        wake();
+        broadcaster.join();
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+    }
+}
+
+int CoopServer::run(const char* path)
+{
+    if (wake_fd < 0) {
+        perror("eventfd");
+        return 1;
+    }
+    const int listen_fd = listen_unix(path);
+    if (listen_fd < 0) {
+        return 1;
+    }
+
+    while (true) {
+        const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0 && (errno == EINTR || errno == ECONNABORTED)) {
+            continue;
+        }
+        if (fd < 0) {
+            perror("accept");
+            break;
+        }
+        {
+            // NOTE: the thread is registered before it can leave, since
+            // leaving takes the lock
+            std::lock_guard<std::mutex> lock(mutex);
+            players.push_back(fd);
+            joined.push_back(fd);
+            player_threads.emplace_back(fd, std::thread(&CoopServer::serve_player, this, fd));
+        }
+        wake();
+    }
+
+    close(listen_fd);
+    unlink(path);
+    return 0;
+}
+
+void CoopServer::serve_player(int fd)
+{
+    std::string buffer;
+    std::vector<int> changes;
+    char chunk[4096];
+    while (true) {
+        const ssize_t length = read(fd, chunk, sizeof(chunk));
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            break;
+        }
+        buffer.append(chunk, length);
+
+        // handle all complete lines
+        size_t begin = 0;
+        size_t end;
+        while ((end = buffer.find('\n', begin)) != std::string::npos) {
+            handle(std::string_view(buffer).substr(begin, end - begin), changes);
+            begin = end + 1;
+        }
+        buffer.erase(0, begin);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        left.push_back(fd);
+    }
+    wake();
+}
+
+void CoopServer::handle(std::string_view line, std::vector<int>& changes)
+{
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    if (line == "new") {
+        {
+            std::unique_lock<std::shared_mutex> lock(game_mutex);
+            board.reset(std::random_device()());
+        }
+        publish({NEW_GAME});
+        return;
+    }
+
+    int row;
+    int col;
+    int code;
+    changes.clear();
+    if (line.starts_with("click ") && parse_cell(line.substr(6), board.rows, board.cols, row, col)) {
+        std::shared_lock<std::shared_mutex> lock(game_mutex);
+        code = board.click_cell(row, col, changes);
+    } else if (line.starts_with("flag ") && parse_cell(line.substr(5), board.rows, board.cols, row, col)) {
+        std::shared_lock<std::shared_mutex> lock(game_mutex);
+        code = board.toggle_flag(row, col, changes);
+    } else {
+        // ignore invalid commands; players only ever see the resulting board
+        return;
+    }
+    if (code == 0) {
+        publish(changes);
+    }
+}
+
+void CoopServer::publish(const std::vector<int>& changes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.insert(pending.end(), changes.begin(), changes.end());
+    }
+    wake();
+}
+
+void CoopServer::wake()
+{
+    const uint64_t one = 1;
+    write(wake_fd, &one, sizeof(one));
+}
+
+void CoopServer::broadcast_loop()
+{
+    std::vector<int> changes;
+    std::vector<int> new_players;
+    std::vector<std::pair<int, std::thread>> finished;
+    std::vector<pollfd> pollfds;
+    std::string message;
+    bool done;
+    while (true) {
+        // wait for queued changes, or for players to take their output
+        pollfds.clear();
+        pollfds.push_back({.fd = wake_fd, .events = POLLIN, .revents = 0});
+        for (const Outbox& outbox : outboxes) {
+            if (!outbox.data.empty()) {
+                pollfds.push_back({.fd = outbox.fd, .events = POLLOUT, .revents = 0});
+            }
+        }
+        if (poll(pollfds.data(), pollfds.size(), -1) < 0 && errno != EINTR) {
+            perror("poll");
+            return;
+        }
+        uint64_t count;
+        read(wake_fd, &count, sizeof(count));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const int fd : left) {
+                players.erase(std::remove(players.begin(), players.end(), fd), players.end());
+                joined.erase(std::remove(joined.begin(), joined.end(), fd), joined.end());
+                const auto thread = std::find_if(player_threads.begin(), player_threads.end(),
+                                                 [fd](const auto& entry) { return entry.first == fd; });
+                assert(thread != player_threads.end());
+                finished.push_back(std::move(*thread));
+                player_threads.erase(thread);
+            }
+            left.clear();
+            done = stopping && players.empty();
+            changes.swap(pending);
+            new_players.swap(joined);
+        }
+
+        // join the threads of players who left, then close their sockets,
+        // which no other thread uses anymore
+        for (auto& [fd, thread] : finished) {
+            thread.join();
+            outboxes.erase(std::remove_if(outboxes.begin(), outboxes.end(),
+                                          [fd](const Outbox& outbox) { return outbox.fd == fd; }),
+                           outboxes.end());
+            close(fd);
+        }
+        finished.clear();
+        if (done) {
+            return;
+        }
+
+        // queue the whole board for new players first, so that the changes
+        // below apply on top of it
+        if (!new_players.empty()) {
+            char hello[64];
+            snprintf(hello, sizeof(hello), "hello %d %d %d\ncells", board.rows, board.cols, board.mines);
+            message = hello;
+            for (int idx = 0; idx < board.rows * board.cols; ++idx) {
+                if (const Cell cell = board.get_cell(idx); cell != 0) {
+                    append_cell(message, idx, cell);
+                }
+            }
+            message += '\n';
+            for (const int fd : new_players) {
+                outboxes.push_back({.fd = fd, .data = message, .max_size = message.size() + MAX_BACKLOG});
+            }
+        }
+
+        // NOTE: we read each cell when sending rather than when it changed,
+        // so that concurrent moves cannot leave players with stale cells
+        message.clear();
+        bool in_cells = false;
+        for (const int idx : changes) {
+            if (idx == NEW_GAME) {
+                message += in_cells ? "\nnew\n" : "new\n";
+                in_cells = false;
+                continue;
+            }
+            if (!in_cells) {
+                message += "cells";
+            }
+            append_cell(message, idx, board.get_cell(idx));
+            in_cells = true;
+        }
+        if (in_cells) {
+            message += '\n';
+        }
+
+        // send as much as each socket takes without blocking, and disconnect
+        // players whose socket failed or who fell too far behind. Their
+        // outbox is dropped once their thread notices
+        for (Outbox& outbox : outboxes) {
+            if (outbox.dropped) {
+                continue;
+            }
+            outbox.data += message;
+            if (!flush(outbox) || outbox.data.size() > outbox.max_size) {
+                shutdown(outbox.fd, SHUT_RDWR);
+                outbox.data.clear();
+                outbox.dropped = true;
+            }
+        }
+
+        changes.clear();
+        new_players.clear();
+    }
+}
+
+bool CoopServer::flush(Outbox& outbox)
+{
+    size_t sent = 0;
+    while (sent < outbox.data.size()) {
+        // NOTE: a player that went away must not kill the server with SIGPIPE
+        const ssize_t length =
+            send(outbox.fd, outbox.data.data() + sent, outbox.data.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length < 0) {
+            return false;
+        }
+        sent += length;
+    }
+    outbox.data.erase(0, sent);
+    return true;
+}
+
+}  // namespace ngames::mines
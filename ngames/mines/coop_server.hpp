@@ -0,0 +1,158 @@
+#pragma once
+
+#include <ngames/mines/shared_board.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Server hosting a single Minesweeper board played by several local players
+ * at once over a Unix domain socket.
+ *
+ * Each player gets a thread that applies their moves straight to a
+ * `SharedBoard`, so a long flood fill never stalls the moves of other players.
+ * The cells changed by each move are queued for a broadcast thread, which
+ * sends them to all players. It reads the state of each cell when sending, so
+ * that every player ends up with the latest state no matter the order in
+ * which concurrent moves were queued. It never blocks on a player: what a
+ * socket does not take right away waits in the player's outbox, and players
+ * whose outbox grows too large are disconnected.
+ *
+ * The protocol is line-oriented. Players send
+ *   click <row> <col>     open or chord a cell
+ *   flag <row> <col>      toggle the flag on a cell
+ *   new                   start a new game
+ * and receive
+ *   hello <rows> <cols> <mines>   once, after connecting
+ *   new                           a new game started, all cells are unopened
+ *   cells <idx>:<cell> ...        packed state of changed cells, see cell.hpp
+ * where <idx> is row * cols + col. Right after `hello`, all cells that are
+ * not unopened are sent.
+ */
+class CoopServer
+{
+public:
+    /**
+     * Create server and start the broadcast thread.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     */
+    CoopServer(int rows, int cols, int mines);
+
+    /**
+     * Disconnect all players and stop all threads.
+     */
+    ~CoopServer();
+
+    CoopServer(const CoopServer&) = delete;
+    CoopServer& operator=(const CoopServer&) = delete;
+
+    /**
+     * Listen on a socket and serve players until accepting a connection fails.
+     * @param path Path of the socket. Any existing file is replaced.
+     * @returns Return code. A non-zero value means the socket could not be
+     * created.
+     */
+    int run(const char* path);
+
+private:
+    /**
+     * Body of the thread of a player. Applies moves until the player
+     * disconnects.
+     * @param fd Socket of the player.
+     */
+    void serve_player(int fd);
+
+    /**
+     * Apply a single command from a player.
+     * @param line Command, without the trailing newline.
+     * @param changes Scratch list for changed cells, reused between commands.
+     */
+    void handle(std::string_view line, std::vector<int>& changes);
+
+    /**
+     * Queue changed cells to be sent to all players.
+     * @param changes Changed cells, or `NEW_GAME`.
+     */
+    void publish(const std::vector<int>& changes);
+
+    /**
+     * Wake up the broadcast thread. Thread-safe.
+     */
+    void wake();
+
+    /**
+     * Output of a player waiting to be sent. Only used by the broadcast
+     * thread.
+     */
+    struct Outbox {
+        // Socket of the player.
+        int fd;
+        // Bytes not sent yet.
+        std::string data;
+        // Most bytes the player may fall behind before being disconnected.
+        size_t max_size;
+        // Whether the player was disconnected, and is only waiting for their
+        // thread to leave.
+        bool dropped = false;
+    };
+
+    /**
+     * Body of the broadcast thread. Sends queued changes until stopped, and
+     * joins the threads of players who left.
+     */
+    void broadcast_loop();
+
+    /**
+     * Send as much of an outbox as its socket takes without blocking.
+     * @param outbox Outbox.
+     * @returns False if the socket failed.
+     */
+    bool flush(Outbox& outbox);
+
+    // Marks the start of a new game in the queue of changed cells.
+    static constexpr int NEW_GAME = -1;
+
+    SharedBoard board;
+    // Held shared by moves and exclusively when starting a new game, which
+    // therefore waits for moves in progress.
+    std::shared_mutex game_mutex;
+
+    // Wakes up the broadcast thread when changes are queued, when players
+    // join or leave, or when stopping.
+    int wake_fd;
+
+    // Guards everything below, up to the outboxes.
+    std::mutex mutex;
+    // Changed cells waiting to be sent.
+    std::vector<int> pending;
+    // Sockets of all connected players. Only the broadcast thread writes to
+    // and closes sockets.
+    std::vector<int> players;
+    // Sockets of players that have not been sent the board yet.
+    std::vector<int> joined;
+    // Sockets of players that have disconnected, to be closed.
+    std::vector<int> left;
+    // Whether the threads should exit.
+    bool stopping;
+    // Threads of the connected players, with their sockets. Joined by the
+    // broadcast thread once they leave.
+    std::vector<std::pair<int, std::thread>> player_threads;
+
+    // Outboxes of the players that were sent the board.
+    std::vector<Outbox> outboxes;
+    std::thread broadcaster;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,147 @@
+#include <ngames/mines/corpus.hpp>
+
+#include <ngames/mines/minesweeper.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+// Most bytes of boards generated by a thread between writes. A chunk holds
+// at least one board, however large.
+constexpr uint64_t CHUNK_BYTES = 4 * 1024 * 1024;
+
+/**
+ * Generate consecutive boards of a corpus.
+ * @param header Header of the corpus.
+ * @param first Index of the first board.
+ * @param count Number of boards.
+ * @param words Set to the boards, see `CorpusHeader`.
+ */
+void generate_boards(
+    const ngames::mines::CorpusHeader& header, uint64_t first, uint64_t count, std::vector<uint64_t>& words)
+{
+    const size_t words_per_board = header.words_per_board();
+    words.assign(count * words_per_board, 0);
+    std::vector<int> idxs;
+    for (uint64_t board = 0; board < count; ++board) {
+        uint64_t* layout = words.data() + board * words_per_board;
+        const unsigned seed = header.first_seed + static_cast<unsigned>(first + board);
+        // place the same mines as `Minesweeper::reset()`, on this thread
+        if (header.rows * header.cols >= ngames::mines::Minesweeper::PARALLEL_MIN_CELLS) {
+            const ngames::mines::MineSelector selector(header.rows * header.cols, header.mines, seed, 1);
+            for (int idx = 0; idx < static_cast<int>(header.rows * header.cols); ++idx) {
+                if (selector.is_mine(idx)) {
+                    layout[idx / 64] |= uint64_t(1) << (idx % 64);
+                }
+            }
+            continue;
+        }
+        ngames::mines::draw_mines(header.rows * header.cols, header.mines, seed, idxs, [&](int idx) {
+            layout[idx / 64] |= uint64_t(1) << (idx % 64);
+        });
+    }
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+int write_corpus(FILE* file, int rows, int cols, int mines, unsigned first_seed, uint64_t count, int num_threads)
+{
+    CorpusHeader header = {
+        .magic = {},
+        .version = CorpusHeader::VERSION,
+        .rows = static_cast<uint32_t>(rows),
+        .cols = static_cast<uint32_t>(cols),
+        .mines = static_cast<uint32_t>(mines),
+        .first_seed = first_seed,
+        .count = count,
+    };
+    std::memcpy(header.magic, CorpusHeader::MAGIC, sizeof(header.magic));
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        return 1;
+    }
+
+    // each round, every thread generates a chunk, then the chunks are written
+    // in order, so the output does not depend on the number of threads
+    num_threads = std::max(num_threads, 1);
+    const uint64_t chunk_boards = std::max<uint64_t>(CHUNK_BYTES / (header.words_per_board() * sizeof(uint64_t)), 1);
+    std::vector<std::vector<uint64_t>> chunks(num_threads);
+    std::vector<std::thread> threads;
+    for (uint64_t first = 0; first < count; first += num_threads * chunk_boards) {
+        for (int i = 0; i < num_threads; ++i) {
+            const uint64_t chunk_first = std::min(first + i * chunk_boards, count);
+            const uint64_t chunk_count = std::min(chunk_boards, count - chunk_first);
+            threads.emplace_back(generate_boards, std::cref(header), chunk_first, chunk_count, std::ref(chunks[i]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+
+        for (const auto& chunk : chunks) {
+            if (fwrite(chunk.data(), sizeof(uint64_t), chunk.size(), file) != chunk.size()) {
+                return 1;
+            }
+        }
+    }
+    return fflush(file) == 0 ? 0 : 1;
+}
+
+Corpus::Corpus(const char* path) : mapping(nullptr), mapping_size(0)
+{
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(CorpusHeader)) {
+        addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return;
+    }
+
+    // check header
+    CorpusHeader header;
+    std::memcpy(&header, addr, sizeof(header));
+    const uint64_t num_cells = static_cast<uint64_t>(header.rows) * header.cols;
+    const bool valid = std::memcmp(header.magic, CorpusHeader::MAGIC, sizeof(header.magic)) == 0 &&
+                       header.version == CorpusHeader::VERSION && header.rows > 0 && header.cols > 0 &&
+                       header.mines < num_cells &&
+                       static_cast<uint64_t>(st.st_size) ==
+                           sizeof(CorpusHeader) + header.count * header.words_per_board() * sizeof(uint64_t);
+    if (!valid) {
+        munmap(addr, st.st_size);
+        return;
+    }
+
+    mapping = static_cast<const std::byte*>(addr);
+    mapping_size = st.st_size;
+    // boards are read in order by most users
+    madvise(addr, mapping_size, MADV_SEQUENTIAL);
+}
+
+Corpus::~Corpus()
+{
+    if (mapping != nullptr) {
+        munmap(const_cast<std::byte*>(mapping), mapping_size);
+    }
+}
+
+}  // namespace ngames::mines
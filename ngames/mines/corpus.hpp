@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Header of a corpus file, i.e. a list of seeded boards of the same size.
+ *
+ * The header is followed by `count` boards, each stored as
+ * `words_per_board()` 64-bit words. Bit `i` of word `i / 64` is set if cell
+ * `i` contains a mine, in reading order, with the mines placed by
+ * `Game::reset(first_seed + b)` for board `b`, before the first click moves
+ * them. All integers are in native byte order, so a corpus is meant to be
+ * loaded on the machine that generated it.
+ */
+struct CorpusHeader {
+    static constexpr char MAGIC[4] = {'M', 'C', 'O', 'R'};
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[4];
+    uint32_t version;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t mines;
+    // Seed of the first board.
+    uint32_t first_seed;
+    // Number of boards.
+    uint64_t count;
+
+    inline size_t words_per_board() const { return (static_cast<size_t>(rows) * cols + 63) / 64; }
+};
+
+static_assert(sizeof(CorpusHeader) == 32);
+
+/**
+ * Generate a corpus and write it to a file, using several threads.
+ * @param file File to write to, e.g. stdout.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param mines Number of mines.
+ * @param first_seed Seed of the first board.
+ * @param count Number of boards.
+ * @param num_threads Number of threads generating boards.
+ * @returns Return code. A non-zero value means that writing failed.
+ */
+int write_corpus(FILE* file, int rows, int cols, int mines, unsigned first_seed, uint64_t count, int num_threads);
+
+/**
+ * Corpus file mapped into memory, exposing its boards without copying them.
+ */
+class Corpus
+{
+public:
+    /**
+     * Map a corpus file into memory. Check `is_open()` for success.
+     * @param path Path to file.
+     */
+    Corpus(const char* path);
+
+    ~Corpus();
+
+    Corpus(const Corpus&) = delete;
+    Corpus& operator=(const Corpus&) = delete;
+
+    /**
+     * Returns true if the file was mapped and holds a valid corpus.
+     */
+    inline bool is_open() const { return mapping != nullptr; }
+
+    inline const CorpusHeader& get_header() const { return *reinterpret_cast<const CorpusHeader*>(mapping); }
+
+    /**
+     * Return the mines of a board, to pass to `Game::reset()`.
+     * @param board Board index.
+     */
+    inline const uint64_t* get_layout(uint64_t board) const
+    {
+        return reinterpret_cast<const uint64_t*>(mapping + sizeof(CorpusHeader)) +
+               board * get_header().words_per_board();
+    }
+
+    /**
+     * Return the seed that places the mines of a board.
+     * @param board Board index.
+     */
+    inline unsigned get_seed(uint64_t board) const { return get_header().first_seed + static_cast<unsigned>(board); }
+
+private:
+    const std::byte* mapping;
+    size_t mapping_size;
+};
+
+}  // namespace ngames::mines
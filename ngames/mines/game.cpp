@@ -0,0 +1,371 @@
+#include <ngames/mines/game.hpp>
+
+#include <ngames/mines/neighbors.hpp>
+#include <ngames/mines/zobrist.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+Game::Game(int rows, int cols, int mines, std::pmr::memory_resource* memory)
+    : Game(rows, cols, mines, std::random_device()(), nullptr, memory)
+{
+}
+
+Game::Game(int rows, int cols, int mines, unsigned seed, const uint64_t* layout, std::pmr::memory_resource* memory)
+    : rows(rows),
+      cols(cols),
+      mines(mines),
+      game(rows, cols, mines, memory),
+      summary(rows, cols, memory),
+      unresolved(rows * cols, memory),
+      tracking_changes(false),
+      flood_queue(memory),
+      flood_head(0),
+      changes(memory),
+      num_resets(0),
+      cells(rows * cols, memory)
+{
+    if (layout != nullptr) {
+        reset(seed, layout);
+    } else {
+        reset(seed);
+    }
+}
+
+void Game::reset()
+{
+    reset(std::random_device()());
+}
+
+void Game::reset(unsigned seed)
+{
+    game.reset(seed);
+    reset_player_state(seed);
+}
+
+void Game::reset(unsigned seed, const uint64_t* layout)
+{
+    game.reset_with_layout(layout);
+    reset_player_state(seed);
+}
+
+void Game::reset_player_state(unsigned seed)
+{
+    this->seed = seed;
+
+    // initialize data
+    state = State::active;
+    num_opened = 0;
+    num_flags = 0;
+    first_opened = std::nullopt;
+    last_opened = std::nullopt;
+    summary.reset();
+    unresolved.clear();
+    clear_changes();
+    ++num_resets;
+
+    // initialize array
+    std::fill(cells.begin(), cells.end(), 0);
+    hash = 0;
+}
+
+void Game::track_changes(bool enable)
+{
+    tracking_changes = enable;
+    if (enable) {
+        changes.reserve(std::min(static_cast<size_t>(rows) * cols, RESERVED_CHANGES));
+    } else {
+        clear_changes();
+    }
+}
+
+void Game::clear_changes() const
+{
+    changes.clear();
+    if (changes.capacity() > MAX_KEPT_CHANGES) {
+        changes.shrink_to_fit();
+    }
+}
+
+void Game::restore(unsigned seed, const std::optional<std::pair<int, int>>& first_opened, const Cell* cells)
+{
+    reset(seed);
+    std::copy(cells, cells + rows * cols, this->cells.begin());
+    this->first_opened = first_opened;
+
+    // rebuild the derived state
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            hash ^= zobrist_key(row * cols + col, get_cell(row, col));
+            if (is_opened(row, col)) {
+                ++num_opened;
+                summary.update(row, col, 1, 0);
+                update_unresolved(row, col);
+            } else if (is_flagged(row, col)) {
+                ++num_flags;
+                summary.update(row, col, 0, 1);
+            }
+        }
+    }
+    game.restore(seed, first_opened, [this](int row, int col) { return is_opened(row, col); });
+
+    // a game that has ended has all its mines revealed
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (is_opened(row, col) && is_known_mine(row, col)) {
+                state = State::lose;
+                last_opened = {row, col};
+            }
+        }
+    }
+    if (state == State::active && check_win()) {
+        state = State::win;
+    }
+}
+
+void Game::set_cell(int row, int col, Cell cell)
+{
+    const Cell prev_cell = get_cell(row, col);
+    const int d_opened = ((cell & CELL_OPENED) != 0) - ((prev_cell & CELL_OPENED) != 0);
+    const int d_flagged = ((cell & CELL_FLAGGED) != 0) - ((prev_cell & CELL_FLAGGED) != 0);
+    write_cell(row, col, cell);
+    mark_changed(row, col);
+
+    num_opened += d_opened;
+    num_flags += d_flagged;
+    if (d_opened != 0 || d_flagged != 0) {
+        summary.update(row, col, d_opened, d_flagged);
+    }
+    if (d_opened > 0) {
+        if (!first_opened.has_value()) {
+            first_opened = {row, col};
+        }
+        last_opened = {row, col};
+    }
+    update_unresolved(row, col);
+    update_neighbors_unresolved(row, col);
+
+    // an opened mine ends the game, as does opening all other cells
+    if ((cell & CELL_OPENED) && (cell & CELL_KNOWN_MINE)) {
+        state = State::lose;
+        last_opened = {row, col};
+    } else if (state == State::active && check_win()) {
+        state = State::win;
+    }
+}
+
+int Game::click_cell(int row, int col)
+{
+    if (state != State::active) {
+        return 1;
+    } else if (is_flagged(row, col)) {
+        return 3;
+    } else if (!is_opened(row, col)) {
+        open(row, col);
+    } else if (can_chord(row, col)) {
+        open_neighbors(row, col);
+    } else {
+        return 2;
+    }
+    return 0;
+}
+
+void Game::open(int row, int col)
+{
+    if (open_cell(row, col)) {
+        flood_queue.push_back(row * cols + col);
+        flood();
+    }
+}
+
+void Game::open_neighbors(int row, int col)
+{
+    flood_queue.push_back(row * cols + col);
+    flood();
+}
+
+bool Game::open_cell(int row, int col)
+{
+    // interact with backend
+    int neighbor_mine_count = UNSET_NEIGHBOR_MINE_COUNT;  // this is set if `is_mine` is false
+    const bool is_mine = game.open(row, col, neighbor_mine_count);
+
+    // update state
+    if (num_opened == 0) {
+        first_opened = {row, col};
+    }
+    write_cell(row, col, get_cell(row, col) | CELL_OPENED);
+    mark_changed(row, col);
+    ++num_opened;
+    last_opened = {row, col};
+    summary.update(row, col, 1, 0);
+
+    // check if lost
+    if (is_mine) {
+        state = State::lose;
+        populate_known_mines();
+        return false;
+    }
+
+    assert(neighbor_mine_count != UNSET_NEIGHBOR_MINE_COUNT);
+    write_cell(row, col, get_cell(row, col) | neighbor_mine_count);
+    update_unresolved(row, col);
+    update_neighbors_unresolved(row, col);
+
+    if (check_win()) {
+        state = State::win;
+        populate_known_mines();
+        return false;
+    }
+
+    // if no neighboring mines, all neighboring cells must be opened
+    return neighbor_mine_count == 0;
+}
+
+void Game::flood()
+{
+    // breadth first, opening each cell as soon as it is queued, so that the
+    // queue only holds the cells along the edge of the opened region
+    while (flood_head < flood_queue.size()) {
+        const int idx = flood_queue[flood_head++];
+        const int row = idx / cols;
+        const int col = idx % cols;
+        for (int nb_row = std::max(row - 1, 0); nb_row <= std::min(row + 1, rows - 1); ++nb_row) {
+            for (int nb_col = std::max(col - 1, 0); nb_col <= std::min(col + 1, cols - 1); ++nb_col) {
+                if (can_open(nb_row, nb_col) && open_cell(nb_row, nb_col)) {
+                    flood_queue.push_back(nb_row * cols + nb_col);
+                }
+            }
+        }
+        // drop the visited cells once they make up half of the queue, which
+        // keeps it within twice the longest edge
+        if (flood_head * 2 >= flood_queue.size()) {
+            flood_queue.erase(flood_queue.begin(), flood_queue.begin() + flood_head);
+            flood_head = 0;
+        }
+    }
+    flood_queue.clear();
+    flood_head = 0;
+    if (flood_queue.capacity() > MAX_KEPT_FLOOD_QUEUE) {
+        flood_queue.shrink_to_fit();
+    }
+}
+
+int Game::toggle_flag(int row, int col)
+{
+    if (state != State::active) {
+        return 1;
+    } else if (is_opened(row, col)) {
+        return 2;
+    }
+
+    if (is_flagged(row, col)) {
+        write_cell(row, col, get_cell(row, col) & ~CELL_FLAGGED);
+        mark_changed(row, col);
+        --num_flags;
+        summary.update(row, col, 0, -1);
+    } else {
+        write_cell(row, col, get_cell(row, col) | CELL_FLAGGED);
+        mark_changed(row, col);
+        ++num_flags;
+        summary.update(row, col, 0, 1);
+    }
+    update_neighbors_unresolved(row, col);
+    return 0;
+}
+
+std::optional<std::pair<int, int>> Game::find_unresolved(int row, int col, bool forward) const
+{
+    if (unresolved.empty()) {
+        return std::nullopt;
+    }
+
+    const int idx = row * cols + col;
+    int found;
+    if (forward) {
+        // first cell after `idx`, wrapping around to the start
+        found = unresolved.next(idx + 1);
+        if (found < 0) {
+            found = unresolved.next(0);
+        }
+    } else {
+        // last cell before `idx`, wrapping around to the end
+        found = unresolved.prev(idx - 1);
+        if (found < 0) {
+            found = unresolved.prev(rows * cols - 1);
+        }
+    }
+    return std::make_pair(found / cols, found % cols);
+}
+
+int Game::count_neighbor_flags(int row, int col) const
+{
+    int count = 0;
+    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+        if (is_flagged(nb_row, nb_col)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int Game::count_neighbor_unopened(int row, int col) const
+{
+    int count = 0;
+    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+        if (!is_opened(nb_row, nb_col)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+int Game::count_neighbor_unknown(int row, int col) const
+{
+    int count = 0;
+    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+        if (!is_opened(nb_row, nb_col) && !is_flagged(nb_row, nb_col)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void Game::update_unresolved(int row, int col)
+{
+    const int idx = row * cols + col;
+    if (is_opened(row, col) && get_neighbor_mine_count(row, col) > 0 && count_neighbor_unknown(row, col) > 0) {
+        unresolved.insert(idx);
+    } else {
+        unresolved.erase(idx);
+    }
+}
+
+void Game::update_neighbors_unresolved(int row, int col)
+{
+    for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+        if (is_opened(nb_row, nb_col)) {
+            update_unresolved(nb_row, nb_col);
+        }
+    }
+}
+
+void Game::populate_known_mines()
+{
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (game.is_mine(row, col)) {
+                write_cell(row, col, get_cell(row, col) | CELL_KNOWN_MINE);
+                mark_changed(row, col);
+            }
+        }
+    }
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <ngames/mines/cell.hpp>
+#include <ngames/mines/cell_set.hpp>
+#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/summary.hpp>
+#include <ngames/mines/zobrist.hpp>
+
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Minesweeper game as seen by the player. Contains information about the game
+ * known by the player, e.g. neighboring mine counts and flags, but does not
+ * display anything. Used directly when playing without a terminal.
+ */
+class Game
+{
+public:
+    static constexpr int UNSET_NEIGHBOR_MINE_COUNT = -1;
+
+    enum State { active, win, lose };
+
+    /**
+     * Create new Minesweeper game.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     * @param memory Memory resource for the allocations of the game, e.g. an arena.
+     */
+    Game(int rows, int cols, int mines, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Create new Minesweeper game, with mines placed as by `reset(seed)`, or
+     * `reset(seed, layout)` if a layout is given.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     * @param seed Seed determining the locations of the mines.
+     * @param layout If not null, precomputed layout of the mines, see `reset()`.
+     * @param memory Memory resource for the allocations of the game, e.g. an arena.
+     */
+    Game(int rows,
+         int cols,
+         int mines,
+         unsigned seed,
+         const uint64_t* layout = nullptr,
+         std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Reset the game, with mines placed using a new random seed.
+     */
+    void reset();
+
+    /**
+     * Reset the game.
+     * @param seed Seed determining the locations of the mines.
+     */
+    void reset(unsigned seed);
+
+    /**
+     * Reset the game with mines placed from a precomputed layout, e.g. from a
+     * corpus, which skips drawing them.
+     * @param seed Seed that places the mines of `layout`, e.g. for replays.
+     * @param layout Bit `i` of word `i / 64` is set if cell `i` contains a
+     * mine, in reading order.
+     */
+    void reset(unsigned seed, const uint64_t* layout);
+
+    /**
+     * Click on a cell.
+     *
+     * If the cell is unopened, the cell will be opened. If the cell contains a
+     * mine, the game will end. If the cell has no neighboring mines, all
+     * neighboring unopened cells will also be opened (this happens
+     * recursively).
+     *
+     * If the cell has already been opened and the number of neighboring flags
+     * equals the number of neighboring mines, all neighboring unopened cells
+     * will be opened (this happens recursively). This is called "chording".
+     *
+     * @param row Cell row.
+     * @param col Cell column.
+     *
+     * @returns Return code. A non-zero value means that an error occurred and
+     * the game state was not been changed. The possible error codes are
+     *   1: game is inactive.
+     *   2: cell has already been opened, and cannot be chorded.
+     *   3: cell has been flagged.
+     */
+    int click_cell(int row, int col);
+
+    /**
+     * Toggle the flag for a cell.
+     *
+     * @param row Cell row.
+     * @param col Cell column.
+     *
+     * @returns Return code. A non-zero value means that an error occurred and
+     * the game state was not been changed. The possible error codes are
+     *   1: game is inactive.
+     *   2: cell has already been opened.
+     */
+    int toggle_flag(int row, int col);
+
+    /**
+     * Find the nearest unresolved cell, i.e. an opened cell with neighboring
+     * mines that still has unopened and unflagged neighbors. Cells are
+     * searched in reading order starting after the given cell, wrapping around
+     * the board. Takes logarithmic time in the number of unresolved cells.
+     *
+     * @param row Cell row to start from.
+     * @param col Cell column to start from.
+     * @param forward If false, search backwards in reading order instead.
+     *
+     * @returns (row, col) of unresolved cell, or null if there are none.
+     */
+    std::optional<std::pair<int, int>> find_unresolved(int row, int col, bool forward = true) const;
+
+    /**
+     * Returns game state.
+     */
+    inline State get_state() const { return state; }
+
+    /**
+     * Return number of flags used.
+     */
+    inline int get_num_flags() const { return num_flags; }
+
+    /**
+     * Return number of opened cells.
+     */
+    inline int get_num_opened() const { return num_opened; }
+
+    /**
+     * Return seed used to place the mines of the current game.
+     */
+    inline unsigned get_seed() const { return seed; }
+
+    /**
+     * Return (row, column) of last opened cell, if any.
+     */
+    inline const std::optional<std::pair<int, int>>& get_last_opened() const { return last_opened; }
+
+    /**
+     * Return summary of opened and flagged cells, for region queries.
+     */
+    inline const Summary& get_summary() const { return summary; }
+
+    /**
+     * Returns true if the cell is known to contain a mine. Mines only become
+     * known once the game has ended.
+     */
+    inline bool is_known_mine(int row, int col) const { return get_cell(row, col) & CELL_KNOWN_MINE; }
+
+    inline bool is_opened(int row, int col) const { return get_cell(row, col) & CELL_OPENED; }
+
+    inline bool is_flagged(int row, int col) const { return get_cell(row, col) & CELL_FLAGGED; }
+
+    /**
+     * Return number of neighboring mines for an opened cell, otherwise
+     * `UNSET_NEIGHBOR_MINE_COUNT`.
+     */
+    inline int get_neighbor_mine_count(int row, int col) const
+    {
+        const Cell cell = get_cell(row, col);
+        return cell & CELL_OPENED ? cell & CELL_COUNT_MASK : UNSET_NEIGHBOR_MINE_COUNT;
+    }
+
+    inline Cell get_cell(int row, int col) const { return cells[row * cols + col]; }
+
+    /**
+     * Return all cells in reading order, i.e. cell (row, col) is at index
+     * row * cols + col.
+     */
+    inline const std::pmr::vector<Cell>& get_cells() const { return cells; }
+
+    /**
+     * Return Zobrist hash of the state visible to the player, i.e. of all
+     * cells, updated in constant time per changed cell. Equal positions on
+     * boards of the same size have equal hashes.
+     */
+    inline uint64_t get_hash() const { return hash; }
+
+    /**
+     * Return (row, column) of first opened cell, if any. Together with the
+     * seed, it determines the locations of all mines.
+     */
+    inline const std::optional<std::pair<int, int>>& get_first_opened() const { return first_opened; }
+
+    /**
+     * Enable or disable tracking of changed cells. Disabled by default.
+     * @param enable Whether to track changes.
+     */
+    void track_changes(bool enable);
+
+    /**
+     * Return cells whose state changed since the last `clear_changes()` or
+     * reset, in order of change. A cell may appear more than once. Only
+     * populated when tracking changes.
+     * NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+     */
+    inline const std::pmr::vector<int>& get_changes() const { return changes; }
+
+    /**
+     * Forget all changed cells. Const so that a reader that only draws them,
+     * e.g. a board refresh, can consume them.
+     */
+    void clear_changes() const;
+
+    /**
+     * Return number of times the game was reset, which also forgets all
+     * changed cells, e.g. so that a reader of `get_changes()` that does not
+     * clear them can tell.
+     */
+    inline uint64_t get_num_resets() const { return num_resets; }
+
+    /**
+     * Restore a game in progress, e.g. from a saved snapshot.
+     * @param seed Seed used to place the mines.
+     * @param first_opened (row, column) of first opened cell, if any.
+     * @param cells Array of `rows * cols` cells in reading order.
+     */
+    void restore(unsigned seed, const std::optional<std::pair<int, int>>& first_opened, const Cell* cells);
+
+    /**
+     * Overwrite the state of a cell with one decided elsewhere, e.g. by a
+     * co-op server, and update the state of the game to match. The back-end
+     * is not consulted, so the game must only be changed this way from then
+     * on.
+     * @param row Cell row.
+     * @param col Cell column.
+     * @param cell New state of the cell.
+     */
+    void set_cell(int row, int col, Cell cell);
+
+    const int rows;
+    const int cols;
+    const int mines;
+
+private:
+    // Most cells `flood_queue` keeps room for after a fill, i.e. 256 KiB. A
+    // fill across a board of 10000x10000 needs about 80k.
+    static constexpr size_t MAX_KEPT_FLOOD_QUEUE = 64 * 1024;
+    // Changed cells `changes` has room for when tracking starts. Readers
+    // clear the list after each move, which rarely changes more cells.
+    static constexpr size_t RESERVED_CHANGES = 1024;
+    // Most changed cells `changes` keeps room for once cleared, i.e. 256 KiB.
+    static constexpr size_t MAX_KEPT_CHANGES = 64 * 1024;
+
+    /**
+     * Returns true if the cell can be opened.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    inline bool can_open(int row, int col) const
+    {
+        return state == State::active && !is_opened(row, col) && !is_flagged(row, col);
+    }
+
+    /**
+     * Returns true if the cell can be chorded.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    inline bool can_chord(int row, int col) const
+    {
+        return state == State::active && is_opened(row, col) && count_neighbor_unopened(row, col) > 0 &&
+               get_neighbor_mine_count(row, col) == count_neighbor_flags(row, col);
+    }
+
+    /**
+     * Open an unopened cell. If the cell contains a mine, the game will end.
+     * If the cell has no neighboring mines, all neighboring unopened cells
+     * will also be opened (this happens recursively).
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void open(int row, int col);
+
+    /**
+     * Open all neighboring unopened cells. See `open()` for more details.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void open_neighbors(int row, int col);
+
+    /**
+     * Open an unopened cell, without opening its neighbors.
+     * @param row Cell row.
+     * @param col Cell column.
+     * @returns True if the cell has no neighboring mines and the game is still
+     * active, i.e. if its neighbors should be opened.
+     */
+    bool open_cell(int row, int col);
+
+    /**
+     * Open the neighbors of the cells on `flood_queue`, and of the neighbors
+     * without neighboring mines in turn, breadth first, until the queue is
+     * empty.
+     */
+    void flood();
+
+    int count_neighbor_flags(int row, int col) const;
+
+    int count_neighbor_unopened(int row, int col) const;
+
+    int count_neighbor_unknown(int row, int col) const;
+
+    /**
+     * Add or remove a cell from `unresolved` according to its current state.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void update_unresolved(int row, int col);
+
+    /**
+     * Call `update_unresolved()` on all neighbors of a cell.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void update_neighbors_unresolved(int row, int col);
+
+    /**
+     * Reset the state known by the player, after the back-end has been reset.
+     * @param seed Seed the back-end was reset with.
+     */
+    void reset_player_state(unsigned seed);
+
+    /**
+     * Returns true if player win condition has been met, i.e. all non-mine
+     * cells have been opened.
+     */
+    inline bool check_win() const { return num_opened + mines == rows * cols; };
+
+    /**
+     * Query `game` for locations of all mines. This will error out if the game
+     * is still active.
+     */
+    void populate_known_mines();
+
+    /**
+     * Change the state of a cell, keeping `hash` up to date.
+     * @param row Cell row.
+     * @param col Cell column.
+     * @param cell New state of the cell.
+     */
+    inline void write_cell(int row, int col, Cell cell)
+    {
+        const int idx = row * cols + col;
+        hash ^= zobrist_key(idx, cells[idx]) ^ zobrist_key(idx, cell);
+        cells[idx] = cell;
+    }
+
+    /**
+     * Record that the state of a cell changed, if tracking changes.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    inline void mark_changed(int row, int col)
+    {
+        if (tracking_changes) {
+            changes.push_back(row * cols + col);
+        }
+    }
+
+    // Game back-end.
+    Minesweeper game;
+
+    // Whether the game is active.
+    State state;
+    // Number of opened cells.
+    int num_opened;
+    // Number of flags used.
+    int num_flags;
+    // Seed used to place the mines.
+    unsigned seed;
+    // (row, column) of first opened cell.
+    std::optional<std::pair<int, int>> first_opened;
+    // (row, column) of last opened cell.
+    std::optional<std::pair<int, int>> last_opened;
+    // Summary of opened and flagged cells.
+    Summary summary;
+    // Opened cells with neighboring mines that still have unopened and
+    // unflagged neighbors, ordered by reading order.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    CellSet unresolved;
+    // Whether to track changed cells.
+    bool tracking_changes;
+    // Cells whose neighbors are to be opened, from `flood_head` on. Kept
+    // between fills to avoid allocating, unless a large fill grew it beyond
+    // `MAX_KEPT_FLOOD_QUEUE`.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::pmr::vector<int> flood_queue;
+    // Position in `flood_queue` of the next cell whose neighbors to open.
+    size_t flood_head;
+    // Changed cells, see `get_changes()`. Kept between moves to avoid
+    // allocating, unless a large fill grew it beyond `MAX_KEPT_CHANGES`.
+    mutable std::pmr::vector<int> changes;
+    // Number of resets, see `get_num_resets()`.
+    uint64_t num_resets;
+
+    // Array with shape (rows, cols) tracking the state of each cell.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::pmr::vector<Cell> cells;
+    // Zobrist hash of `cells`, see `get_hash()`.
+    uint64_t hash;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,163 @@
+#include <ngames/mines/hinter.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+Hinter::Hinter(int rows, int cols, int mines, std::chrono::milliseconds budget)
+    : cache(CACHE_ENTRIES),
+      solver(std::max(1u, std::thread::hardware_concurrency()), &cache),
+      budget(budget),
+      staging(rows * cols, 0),
+      staging_row(0),
+      staging_col(0),
+      pending(false),
+      waiting(false),
+      ready(false),
+      stopping(false),
+      cells(rows * cols, 0),
+      working(rows, cols, mines),
+      working_row(0),
+      working_col(0),
+      thread(&Hinter::loop, this)
+{
+}
+
+Hinter::~Hinter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        interrupt.cancelled = true;
+    }
+    cv.notify_one();
+    thread.join();
+}
+
+void Hinter::request(const Game& game, int row, int col)
+{
+    assert(game.get_cells().size() == staging.size());  // game must have the same size
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::copy(game.get_cells().begin(), game.get_cells().end(), staging.begin());
+        staging_row = row;
+        staging_col = col;
+        pending = true;
+        waiting = true;
+        ready = false;
+        // stop the hint in progress, if any, since nobody will take it
+        interrupt.cancelled = true;
+    }
+    cv.notify_one();
+}
+
+std::optional<Hint> Hinter::take()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready) {
+        return std::nullopt;
+    }
+    ready = false;
+    waiting = false;
+    return std::exchange(result, std::nullopt);
+}
+
+bool Hinter::is_pending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return waiting;
+}
+
+void Hinter::loop()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return pending || stopping; });
+            if (stopping) {
+                return;
+            }
+            std::swap(staging, cells);
+            working_row = staging_row;
+            working_col = staging_col;
+            pending = false;
+            interrupt.cancelled = false;
+        }
+
+        // NOTE: only the enumeration of components can be cut short; copying
+        // the position and finding its components take time linear in the
+        // number of cells, which exceeds small budgets on huge boards
+        interrupt.deadline = std::chrono::steady_clock::now() + budget;
+        for (int row = 0; row < working.rows; ++row) {
+            for (int col = 0; col < working.cols; ++col) {
+                const Cell cell = cells[row * working.cols + col];
+                if (working.get_cell(row, col) != cell) {
+                    working.set_cell(row, col, cell);
+                }
+            }
+        }
+        solver.analyze(working, analysis, &interrupt);
+        const std::optional<Hint> hint = pick();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // drop the hint if a newer request came in meanwhile
+            if (!pending) {
+                result = hint;
+                ready = true;
+            }
+        }
+    }
+}
+
+std::optional<Hint> Hinter::pick() const
+{
+    const int cols = working.cols;
+    const auto distance = [&](int idx) {
+        return std::max(std::abs(idx / cols - working_row), std::abs(idx % cols - working_col));
+    };
+
+    // prefer the closest safe cell, and otherwise the closest of the cells
+    // least likely to contain a mine
+    int best = -1;
+    for (const int idx : analysis.safe_cells) {
+        if (!working.is_flagged(idx / cols, idx % cols) && (best < 0 || distance(idx) < distance(best))) {
+            best = idx;
+        }
+    }
+    const bool safe = best >= 0;
+    if (!safe) {
+        double best_probability = std::numeric_limits<double>::infinity();
+        for (int idx = 0; idx < working.rows * cols; ++idx) {
+            if (working.is_opened(idx / cols, idx % cols) || working.is_flagged(idx / cols, idx % cols)) {
+                continue;
+            }
+            const double probability = analysis.probabilities[idx];
+            if (probability < best_probability || (probability == best_probability && distance(idx) < distance(best))) {
+                best = idx;
+                best_probability = probability;
+            }
+        }
+    }
+    if (best < 0) {
+        return std::nullopt;
+    }
+    return Hint{
+        .hash = working.get_hash(),
+        .row = best / cols,
+        .col = best % cols,
+        .safe = safe,
+        .probability = safe ? 0.0 : analysis.probabilities[best],
+        .partial = analysis.interrupted,
+    };
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <ngames/mines/cell.hpp>
+#include <ngames/mines/game.hpp>
+#include <ngames/mines/solver.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Suggested next cell to open.
+ */
+struct Hint {
+    // Hash of the position the hint is for, see `Game::get_hash()`.
+    uint64_t hash;
+    int row;
+    int col;
+    // Whether the cell is certain not to contain a mine. Otherwise, it is the
+    // cell least likely to contain one.
+    bool safe;
+    // Probability that the cell contains a mine.
+    double probability;
+    // Whether the analysis ran out of time, so the hint may not be the best.
+    bool partial;
+};
+
+/**
+ * Computes hints on a background thread, so that the player can keep playing
+ * while a position is analyzed.
+ *
+ * Each hint is computed within a time budget: once it runs out, the
+ * components of the position not enumerated yet are estimated instead, so a
+ * hint is always ready shortly after the budget, even on large frontiers. A
+ * new request cancels the one in progress. Component enumerations are cached
+ * between requests, so the parts of the board a move did not touch are not
+ * enumerated again.
+ */
+class Hinter
+{
+public:
+    // Default time budget of a hint.
+    static constexpr std::chrono::milliseconds DEFAULT_BUDGET{50};
+    // Number of component enumerations cached between requests.
+    static constexpr int CACHE_ENTRIES = 1 << 14;
+
+    /**
+     * Start the background thread.
+     * @param rows Number of rows of the game.
+     * @param cols Number of columns of the game.
+     * @param mines Number of mines of the game.
+     * @param budget Time budget of each hint.
+     */
+    Hinter(int rows, int cols, int mines, std::chrono::milliseconds budget = DEFAULT_BUDGET);
+
+    /**
+     * Cancel any hint in progress, and then stop the background thread.
+     */
+    ~Hinter();
+
+    Hinter(const Hinter&) = delete;
+    Hinter& operator=(const Hinter&) = delete;
+
+    /**
+     * Start computing a hint for a position, cancelling any hint in progress.
+     * Only copies the game's cells.
+     * @param game Game, with the same size as given to the constructor. Should
+     * be active.
+     * @param row Row of the cursor; among equally good cells, the one closest
+     * to the cursor is suggested.
+     * @param col Column of the cursor.
+     */
+    void request(const Game& game, int row, int col);
+
+    /**
+     * Take the hint of the latest request, if it is ready.
+     * @returns The hint, or nothing if it is not ready yet, or if the position
+     * has no unopened cell left.
+     */
+    std::optional<Hint> take();
+
+    /**
+     * Returns true if a hint was requested and not taken yet.
+     */
+    bool is_pending();
+
+private:
+    /**
+     * Body of the background thread. Computes requested hints until stopped.
+     */
+    void loop();
+
+    /**
+     * Pick the hint of the analyzed position.
+     * @returns The hint, or nothing if the position has no unopened cell left.
+     */
+    std::optional<Hint> pick() const;
+
+    Solver::Cache cache;
+    Solver solver;
+    Solver::Interrupt interrupt;
+    const std::chrono::milliseconds budget;
+
+    // Guards `staging`, `pending`, `waiting`, `ready`, `result` and
+    // `stopping`.
+    std::mutex mutex;
+    std::condition_variable cv;
+    // Cells of the latest requested position, and cursor position.
+    std::vector<Cell> staging;
+    int staging_row;
+    int staging_col;
+    // Whether `staging` holds a request that is not being computed yet.
+    bool pending;
+    // Whether the hint of the latest request was not taken yet.
+    bool waiting;
+    // Whether `result` holds the hint of the latest request.
+    bool ready;
+    std::optional<Hint> result;
+    // Whether the background thread should exit.
+    bool stopping;
+
+    // Position being analyzed by the background thread, updated one changed
+    // cell at a time from `cells`, which is swapped with `staging`.
+    std::vector<Cell> cells;
+    Game working;
+    int working_row;
+    int working_col;
+    Analysis analysis;
+
+    std::thread thread;
+};
+
+}  // namespace ngames::mines
@@ -1,9 +1,29 @@
 #include <ngames/mines/app.hpp>
+#include <ngames/mines/autosave.hpp>
+#include <ngames/mines/bot_protocol.hpp>
+#include <ngames/mines/coop_client.hpp>
+#include <ngames/mines/coop_server.hpp>
+#include <ngames/mines/corpus.hpp>
+#include <ngames/mines/game.hpp>
+#include <ngames/mines/hinter.hpp>
+#include <ngames/mines/replay.hpp>
+#include <ngames/mines/telemetry.hpp>
 
 #include <ngames/common/ncurses.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include <unistd.h>
 
 
 /**
@@ -16,6 +36,23 @@
     fprintf(stderr, "  mines i                intermediate (16x16, 40 mines)\n");
     fprintf(stderr, "  mines e                expert       (30x16, 99 mines)\n");
     fprintf(stderr, "  mines <r> <c> <m>      custom       (r x c,  m mines)\n");
+    fprintf(stderr, "  mines --resume         resume the last autosaved game, and keep autosaving it\n");
+    fprintf(stderr, "  mines --bot            play through a text protocol on stdin/stdout, see bot_protocol.hpp\n");
+    fprintf(stderr, "  mines --serve <sock> <board>   host a co-op game on a Unix socket, with board as above\n");
+    fprintf(stderr, "  mines --join <sock>    join a co-op game\n");
+    fprintf(stderr, "  mines --generate <n> <board>   write a corpus of n seeded boards, with board as above\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  --record <file>        record the session to a file\n");
+    fprintf(stderr, "  --autosave             save the game to ~/.mines_autosave in the background, for --resume\n");
+    fprintf(stderr, "  --hint-budget <ms>     most time to compute a hint before showing the best so far (default 50)\n");
+    fprintf(stderr, "  --telemetry <file>     write think time and input-to-screen latency histograms to a file on exit\n");
+    fprintf(stderr, "  --replay <file>        replay a recorded session, instead of playing\n");
+    fprintf(stderr, "  --speed <x>            replay at x times real time (default 1)\n");
+    fprintf(stderr, "  --max                  replay as fast as possible\n");
+    fprintf(stderr, "  --headless             replay as fast as possible without display, and print timings\n");
+    fprintf(stderr, "  --seed <s>             seed of the first generated board (default 1)\n");
+    fprintf(stderr, "  --output <file>        write generated boards to a file instead of stdout\n");
     exit(EXIT_FAILURE);
 }
 
@@ -44,19 +81,78 @@ static int str_to_int(const char* str)
     return i;
 }
 
-struct Args {
+/**
+ * Convert string to floating point number. If an error occurs, prints a
+ * helpful message to the user and then exits the program.
+ * @param str The string to convert.
+ */
+static double str_to_double(const char* str)
+{
+    double d;
+    size_t pos;
+    try {
+        d = std::stod(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not a number: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not a number: %s\n", str);
+        help_and_exit();
+    }
+    return d;
+}
+
+struct BoardArgs {
     int rows;
     int cols;
     int mines;
 };
 
+struct Args {
+    // Board size; unset when replaying, since the recording contains it.
+    BoardArgs board = {};
+    // File to record the session to, if any.
+    const char* record_path = nullptr;
+    // Time budget of hints, in milliseconds.
+    int hint_budget_ms = ngames::mines::Hinter::DEFAULT_BUDGET.count();
+    // File to write the timings of input events to on exit, if any.
+    const char* telemetry_path = nullptr;
+    // File to replay, if any.
+    const char* replay_path = nullptr;
+    // Replay speed relative to real time, or zero for as fast as possible.
+    double replay_speed = 1.0;
+    // Replay without display.
+    bool headless = false;
+    // Save the game in the background.
+    bool autosave = false;
+    // Resume the autosaved game.
+    bool resume = false;
+    // Play through the bot protocol.
+    bool bot = false;
+    // Socket to host a co-op game on, if any.
+    const char* serve_path = nullptr;
+    // Socket of the co-op game to join, if any.
+    const char* join_path = nullptr;
+    // Number of boards to generate, if any.
+    int generate = 0;
+    // Seed of the first generated board.
+    unsigned generate_seed = 1;
+    // File to write generated boards to, or null for stdout.
+    const char* output_path = nullptr;
+};
+
 /**
- * Parse command line arguments. If an error occurs, prints a helpful message
- * to the user and then exits the program.
+ * Parse the board size from the positional command line arguments. If an
+ * error occurs, prints a helpful message to the user and then exits the
+ * program.
  * @param argc
  * @param argv
  */
-static Args get_args(int argc, char** argv)
+static BoardArgs get_board_args(int argc, char** argv)
 {
     switch (argc) {
         case 1:
@@ -99,6 +195,10 @@ static Args get_args(int argc, char** argv)
                 fprintf(stderr, "Not enough mines (%d); must be at least %d\n", mines, min_mines);
                 help_and_exit();
             }
+            if (static_cast<int64_t>(rows) * cols > INT_MAX) {
+                fprintf(stderr, "Too many cells (%d x %d); can be at most %d\n", rows, cols, INT_MAX);
+                help_and_exit();
+            }
             // since first cell is always empty, can have at most (rows * cols - 1) mines
             const int max_mines = rows * cols - 1;
             if (mines > max_mines) {
@@ -114,15 +214,389 @@ static Args get_args(int argc, char** argv)
     }
 }
 
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+
+    // separate options from positional arguments
+    std::vector<char*> positional = {argv[0]};
+    // number of arguments of options that only apply while playing
+    int num_play_args = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--record" && has_value) {
+            args.record_path = argv[++i];
+        } else if (arg == "--hint-budget" && has_value) {
+            args.hint_budget_ms = str_to_int(argv[++i]);
+            num_play_args += 2;
+            if (args.hint_budget_ms <= 0) {
+                fprintf(stderr, "Hint budget must be positive: %s\n", argv[i]);
+                help_and_exit();
+            }
+        } else if (arg == "--telemetry" && has_value) {
+            args.telemetry_path = argv[++i];
+            num_play_args += 2;
+        } else if (arg == "--replay" && has_value) {
+            args.replay_path = argv[++i];
+        } else if (arg == "--speed" && has_value) {
+            args.replay_speed = str_to_double(argv[++i]);
+            if (args.replay_speed <= 0) {
+                fprintf(stderr, "Speed must be positive: %s\n", argv[i]);
+                help_and_exit();
+            }
+        } else if (arg == "--max") {
+            args.replay_speed = 0;
+        } else if (arg == "--headless") {
+            args.headless = true;
+        } else if (arg == "--autosave") {
+            args.autosave = true;
+        } else if (arg == "--resume") {
+            args.resume = true;
+        } else if (arg == "--bot") {
+            args.bot = true;
+        } else if (arg == "--serve" && has_value) {
+            args.serve_path = argv[++i];
+        } else if (arg == "--join" && has_value) {
+            args.join_path = argv[++i];
+        } else if (arg == "--generate" && has_value) {
+            args.generate = str_to_int(argv[++i]);
+            if (args.generate <= 0) {
+                fprintf(stderr, "Number of boards must be positive: %s\n", argv[i]);
+                help_and_exit();
+            }
+        } else if (arg == "--seed" && has_value) {
+            args.generate_seed = str_to_int(argv[++i]);
+        } else if (arg == "--output" && has_value) {
+            args.output_path = argv[++i];
+        } else if (arg.starts_with("--")) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (args.bot) {
+        if (positional.size() > 1 || argc > 2) {
+            fprintf(stderr, "Cannot combine --bot with other options.\n");
+            help_and_exit();
+        }
+        return args;
+    }
+    if (num_play_args > 0 && (args.generate > 0 || args.serve_path != nullptr || args.replay_path != nullptr)) {
+        fprintf(stderr, "Hints and telemetry are only available while playing.\n");
+        help_and_exit();
+    }
+    if (args.join_path != nullptr) {
+        if (positional.size() > 1 || argc > 3 + num_play_args) {
+            fprintf(stderr, "Cannot combine --join with other options.\n");
+            help_and_exit();
+        }
+        return args;
+    }
+    if (args.generate > 0) {
+        if (args.serve_path != nullptr || args.record_path != nullptr || args.replay_path != nullptr || args.autosave ||
+            args.resume) {
+            fprintf(stderr, "Cannot combine --generate with other options.\n");
+            help_and_exit();
+        }
+        args.board = get_board_args(positional.size(), positional.data());
+        return args;
+    }
+    if (args.serve_path != nullptr &&
+        (args.record_path != nullptr || args.replay_path != nullptr || args.autosave || args.resume)) {
+        fprintf(stderr, "Cannot record, replay, autosave or resume while hosting.\n");
+        help_and_exit();
+    }
+    if (args.replay_path != nullptr) {
+        if (positional.size() > 1 || args.record_path != nullptr || args.autosave) {
+            fprintf(stderr, "Cannot play, record or autosave while replaying.\n");
+            help_and_exit();
+        }
+        return args;
+    }
+    if (args.headless) {
+        fprintf(stderr, "Nothing to replay.\n");
+        help_and_exit();
+    }
+    if (args.resume) {
+        if (positional.size() > 1 || args.record_path != nullptr) {
+            fprintf(stderr, "Cannot start a new game or record while resuming.\n");
+            help_and_exit();
+        }
+        return args;
+    }
+
+    args.board = get_board_args(positional.size(), positional.data());
+    return args;
+}
+
+/**
+ * Open a file. If an error occurs, prints a helpful message to the user and
+ * then exits the program.
+ * @param path Path to file.
+ * @param mode Mode passed to `fopen()`.
+ */
+static FILE* open_or_exit(const char* path, const char* mode)
+{
+    FILE* file = fopen(path, mode);
+    if (file == nullptr) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    return file;
+}
+
+/**
+ * Read the header of a replay. If the replay is invalid, prints a helpful
+ * message to the user and then exits the program.
+ * @param reader Replay reader.
+ * @param path Path to the replay, for error messages.
+ */
+static ngames::mines::ReplayHeader read_header_or_exit(ngames::mines::ReplayReader& reader, const char* path)
+{
+    ngames::mines::ReplayHeader header;
+    if (!reader.read_header(header) || header.rows < ngames::mines::Minesweeper::MIN_ROWS ||
+        header.cols < ngames::mines::Minesweeper::MIN_COLS ||
+        static_cast<int64_t>(header.rows) * header.cols > INT_MAX ||
+        header.mines < ngames::mines::Minesweeper::MIN_MINES || header.mines > header.rows * header.cols - 1) {
+        fprintf(stderr, "Not a valid replay: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    return header;
+}
+
+/**
+ * Return path to the autosave file, or an empty string if there is no home
+ * directory.
+ */
+static std::string get_autosave_path()
+{
+    const char* home = getenv("HOME");
+    return home != nullptr ? std::string(home) + "/.mines_autosave" : "";
+}
+
+/**
+ * Load the autosaved game. If there is none, prints a helpful message to the
+ * user and then exits the program.
+ * @param path Path to the autosave file.
+ */
+static ngames::mines::Snapshot load_autosave_or_exit(const std::string& path)
+{
+    ngames::mines::Snapshot snapshot;
+    if (path.empty() || !ngames::mines::Autosaver::load(path.c_str(), snapshot) ||
+        static_cast<int64_t>(snapshot.rows) * snapshot.cols > INT_MAX ||
+        snapshot.mines < ngames::mines::Minesweeper::MIN_MINES || snapshot.mines > snapshot.rows * snapshot.cols - 1) {
+        fprintf(stderr, "No saved game to resume.\n");
+        exit(EXIT_FAILURE);
+    }
+    return snapshot;
+}
+
+/**
+ * Replay a recorded session as fast as possible without display, and print
+ * timings and the final game state as a single line of `key=value` pairs.
+ * @param reader Replay reader whose header has already been read.
+ * @param header Replay header.
+ */
+static void replay_headless(ngames::mines::ReplayReader& reader, const ngames::mines::ReplayHeader& header)
+{
+    ngames::mines::Game game(header.rows, header.cols, header.mines, header.seed);
+
+    long num_events = 0;
+    ngames::mines::ReplayEvent event;
+    const auto start_time = std::chrono::steady_clock::now();
+    while (reader.read_event(event)) {
+        ngames::mines::apply_event(game, event);
+        ++num_events;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+    const long elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    const char* state = "active";
+    if (game.get_state() == ngames::mines::Game::State::win) {
+        state = "win";
+    } else if (game.get_state() == ngames::mines::Game::State::lose) {
+        state = "lose";
+    }
+    printf(
+        "events=%ld time_ns=%ld ns_per_event=%.1f state=%s opened=%d flags=%d\n",
+        num_events,
+        elapsed_ns,
+        num_events > 0 ? static_cast<double>(elapsed_ns) / num_events : 0.0,
+        state,
+        game.get_num_opened(),
+        game.get_num_flags());
+}
+
+/**
+ * Play through the bot protocol, reading requests from stdin and writing
+ * replies to stdout until stdin is closed.
+ */
+static void run_bot()
+{
+    ngames::mines::BotProtocol protocol;
+    std::string reply;
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, stdin)) >= 0) {
+        if (length > 0 && line[length - 1] == '\n') {
+            --length;
+        }
+        protocol.handle(std::string_view(line, length), reply);
+        reply += '\n';
+        fwrite(reply.data(), 1, reply.size(), stdout);
+        // bots wait for each reply before sending more
+        fflush(stdout);
+    }
+    free(line);
+}
+
 int main(int argc, char** argv)
 {
     const Args args = get_args(argc, argv);
 
+    if (args.bot) {
+        run_bot();
+        return EXIT_SUCCESS;
+    }
+
+    if (args.generate > 0) {
+        FILE* file = args.output_path != nullptr ? open_or_exit(args.output_path, "wb") : stdout;
+        if (file == stdout && isatty(fileno(stdout))) {
+            fprintf(stderr, "Refusing to write a binary corpus to a terminal; use --output or a redirection.\n");
+            return EXIT_FAILURE;
+        }
+        const int num_threads = std::max(1u, std::thread::hardware_concurrency());
+        const int code = ngames::mines::write_corpus(
+            file, args.board.rows, args.board.cols, args.board.mines, args.generate_seed, args.generate, num_threads);
+        if (code != 0 || fclose(file) != 0) {
+            perror(args.output_path != nullptr ? args.output_path : "stdout");
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (args.serve_path != nullptr) {
+        ngames::mines::CoopServer server(args.board.rows, args.board.cols, args.board.mines);
+        printf("Hosting on %s, join with: mines --join %s\n", args.serve_path, args.serve_path);
+        fflush(stdout);
+        return server.run(args.serve_path) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (args.join_path != nullptr) {
+        ngames::mines::CoopClient client(args.join_path);
+        if (!client.is_connected()) {
+            fprintf(stderr, "Cannot join co-op game: %s\n", args.join_path);
+            return EXIT_FAILURE;
+        }
+
+        FILE* telemetry_file = args.telemetry_path != nullptr ? open_or_exit(args.telemetry_path, "w") : nullptr;
+        std::optional<ngames::mines::Telemetry> telemetry;
+        if (telemetry_file != nullptr) {
+            telemetry.emplace();
+        }
+
+        ngames::init_ncurses();
+
+        ngames::mines::App app(client.rows,
+                               client.cols,
+                               client.mines,
+                               nullptr,
+                               nullptr,
+                               &client,
+                               telemetry.has_value() ? &*telemetry : nullptr);
+        app.set_hint_budget(std::chrono::milliseconds(args.hint_budget_ms));
+        app.run();
+
+        ngames::end_ncurses();
+
+        if (telemetry_file != nullptr) {
+            telemetry->write(telemetry_file);
+            fclose(telemetry_file);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (args.replay_path != nullptr) {
+        FILE* replay_file = open_or_exit(args.replay_path, "rb");
+        ngames::mines::ReplayReader reader(replay_file);
+        const auto header = read_header_or_exit(reader, args.replay_path);
+
+        if (args.headless) {
+            replay_headless(reader, header);
+        } else {
+            ngames::init_ncurses();
+
+            ngames::mines::App app(
+                header.rows, header.cols, header.mines, nullptr, nullptr, nullptr, nullptr, nullptr, header.seed);
+            app.replay(reader, args.replay_speed);
+            app.run();
+
+            ngames::end_ncurses();
+        }
+        fclose(replay_file);
+        return EXIT_SUCCESS;
+    }
+
+    const std::string autosave_path = get_autosave_path();
+    std::optional<ngames::mines::Snapshot> snapshot;
+    if (args.resume) {
+        snapshot = load_autosave_or_exit(autosave_path);
+    }
+    const int rows = snapshot.has_value() ? snapshot->rows : args.board.rows;
+    const int cols = snapshot.has_value() ? snapshot->cols : args.board.cols;
+    const int mines = snapshot.has_value() ? snapshot->mines : args.board.mines;
+
+    FILE* record_file = args.record_path != nullptr ? open_or_exit(args.record_path, "wb") : nullptr;
+    FILE* telemetry_file = args.telemetry_path != nullptr ? open_or_exit(args.telemetry_path, "w") : nullptr;
+    std::optional<ngames::mines::Telemetry> telemetry;
+    if (telemetry_file != nullptr) {
+        telemetry.emplace();
+    }
+    // NOTE: a resumed game keeps being saved, so that it is not lost again
+    std::optional<ngames::mines::Autosaver> autosaver;
+    if (args.autosave || args.resume) {
+        if (autosave_path.empty()) {
+            fprintf(stderr, "Cannot autosave without a home directory.\n");
+            exit(EXIT_FAILURE);
+        }
+        autosaver.emplace(autosave_path.c_str(), rows, cols, mines);
+        if (!autosaver->is_open()) {
+            fprintf(stderr, "Cannot write autosave file: %s\n", autosave_path.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+
     ngames::init_ncurses();
 
-    ngames::mines::App app(args.rows, args.cols, args.mines);
+    ngames::mines::App app(rows,
+                           cols,
+                           mines,
+                           record_file,
+                           autosaver.has_value() ? &*autosaver : nullptr,
+                           nullptr,
+                           telemetry.has_value() ? &*telemetry : nullptr,
+                           snapshot.has_value() ? &*snapshot : nullptr);
+    app.set_hint_budget(std::chrono::milliseconds(args.hint_budget_ms));
     app.run();
 
     ngames::end_ncurses();
+
+    if (record_file != nullptr) {
+        fclose(record_file);
+    }
+    if (telemetry_file != nullptr) {
+        telemetry->write(telemetry_file);
+        fclose(telemetry_file);
+    }
     return EXIT_SUCCESS;
 }
@@ -3,56 +3,80 @@
 #include <ngames/mines/neighbors.hpp>
 
 #include <algorithm>
-#include <numeric>
+#include <atomic>
+#include <bit>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <cassert>
-#include <ctime>
 
 
 namespace
 {
 
+// Cells per band, i.e. per unit of work taken by a thread. Bands do not depend
+// on the number of threads.
+constexpr int64_t BAND_CELLS = int64_t(1) << 20;
+
+/**
+ * Call a function for each band, on several threads, each taking the next
+ * band left until there are none.
+ * @param num_bands Number of bands.
+ * @param num_threads Most threads, including the calling thread.
+ * @param f Called with (thread, band), where thread is in [0, num_threads).
+ */
+template <typename F>
+void for_each_band(int64_t num_bands, int num_threads, const F& f)
+{
+    std::atomic<int64_t> next_band = 0;
+    const auto work = [&](int thread) {
+        for (int64_t band = next_band++; band < num_bands; band = next_band++) {
+            f(thread, band);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < std::min<int64_t>(num_threads, num_bands); ++thread) {
+        threads.emplace_back(work, thread);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * Call a function for each band of rows of a board, on several threads.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param num_threads Most threads, including the calling thread.
+ * @param f Called with (first_row, end_row) of each band.
+ */
+template <typename F>
+void for_each_row_band(int rows, int cols, int num_threads, const F& f)
+{
+    const int band_rows = std::max<int64_t>(1, BAND_CELLS / cols);
+    for_each_band((rows + band_rows - 1) / band_rows, num_threads, [&](int, int64_t band) {
+        f(band * band_rows, std::min<int64_t>(rows, (band + 1) * band_rows));
+    });
+}
+
 /**
  * Randomly populate mines. Cell (0, 0) is guaranteed to not contain a mine.
  * @param is_mine_array Array tracking which cells contain a mine, initially all false.
  * @param num_mines Number of mines to create.
+ * @param seed Seed for the RNG.
+ * @param idxs Scratch list of indices, reused between calls to avoid allocating.
  */
-void populate_mines(std::vector<std::vector<bool>>& is_mine_array, int num_mines)
+void populate_mines(
+    std::pmr::vector<std::pmr::vector<bool>>& is_mine_array, int num_mines, unsigned seed, std::pmr::vector<int>& idxs)
 {
-    // seed RNG with current time
-    std::srand(clock());
-
     const int num_rows = is_mine_array.size();
     const int num_cols = is_mine_array.front().size();
-    const int num_cells = num_rows * num_cols;
-
-    // create list of indices
-    // NOTE: we encode the pair (row, col) as a single integer: row * num_cols + col
-    std::vector<int> idxs(num_cells);
-    std::iota(idxs.begin(), idxs.end(), 0);
-
-    // we draw indices at random to populate mines, removing drawn indices from
-    // the list to avoid drawing duplicates. we can remove an element in O(1)
-    // time by replacing it with the last element of the list. to guarantee
-    // index `0` not contain a mine, we remove it from the list.
-    idxs.front() = idxs.back();
-    idxs.pop_back();
-
-    // number of mines cannot be too large
-    assert(static_cast<int>(idxs.size()) >= num_mines);
-
-    for (int draw = 0; draw < num_mines; ++draw) {
-        // pick random index from the list
-        const int idx_idx = std::rand() % idxs.size();
-        const int idx = idxs[idx_idx];
-        // create mine
-        const int row = idx / num_cols;
-        const int col = idx % num_cols;
-        is_mine_array[row][col] = true;
-        // remove drawn index from list
-        idxs[idx_idx] = idxs.back();
-        idxs.pop_back();
-    }
+
+    ngames::mines::draw_mines(num_rows * num_cols, num_mines, seed, idxs, [&](int idx) {
+        is_mine_array[idx / num_cols][idx % num_cols] = true;
+    });
 
     // sanity check (0, 0) does not contain a mine
     assert(!is_mine_array[0][0]);
@@ -64,8 +88,70 @@ void populate_mines(std::vector<std::vector<bool>>& is_mine_array, int num_mines
 namespace ngames::mines
 {
 
-Minesweeper::Minesweeper(int rows, int cols, int mines) : rows(rows), cols(cols), mines(mines)
+MineSelector::MineSelector(int64_t num_cells, int64_t num_mines, unsigned seed, int num_threads)
+    : seed_key(0), last_key(0), last_idx(-1)
+{
+    assert(num_mines < num_cells);  // cell 0 never contains a mine
+
+    // NOTE: SplitMix64 of the seed, so that close seeds draw unrelated keys
+    seed_key = seed;
+    seed_key = get_key(0);
+    if (num_mines == 0) {
+        return;
+    }
+
+    // count the keys with each top 16 bits, to find the range of the last
+    // mine, then sort out the keys in that range
+    constexpr int BUCKET_SHIFT = 48;
+    const int64_t num_bands = (num_cells + BAND_CELLS - 1) / BAND_CELLS;
+    num_threads = std::max<int64_t>(1, std::min<int64_t>(num_threads, num_bands));
+    const auto for_each_cell = [&](const auto& f) {
+        for_each_band(num_bands, num_threads, [&](int thread, int64_t band) {
+            const int64_t end = std::min(num_cells, (band + 1) * BAND_CELLS);
+            for (int64_t idx = std::max<int64_t>(1, band * BAND_CELLS); idx < end; ++idx) {
+                f(thread, idx, get_key(idx));
+            }
+        });
+    };
+
+    std::vector<std::vector<int64_t>> counts(num_threads, std::vector<int64_t>(1 << (64 - BUCKET_SHIFT)));
+    for_each_cell([&](int thread, int64_t, uint64_t key) { ++counts[thread][key >> BUCKET_SHIFT]; });
+    uint64_t bucket = 0;
+    int64_t below = 0;
+    while (true) {
+        int64_t count = 0;
+        for (const auto& thread_counts : counts) {
+            count += thread_counts[bucket];
+        }
+        if (below + count >= num_mines) {
+            break;
+        }
+        below += count;
+        ++bucket;
+    }
+
+    // NOTE: threads collect the keys in any order, but the last mine is the
+    // same once they are sorted by key and then index
+    std::vector<std::vector<std::pair<uint64_t, int64_t>>> keys(num_threads);
+    for_each_cell([&](int thread, int64_t idx, uint64_t key) {
+        if (key >> BUCKET_SHIFT == bucket) {
+            keys[thread].emplace_back(key, idx);
+        }
+    });
+    for (size_t thread = 1; thread < keys.size(); ++thread) {
+        keys[0].insert(keys[0].end(), keys[thread].begin(), keys[thread].end());
+    }
+    const auto last = keys[0].begin() + (num_mines - below - 1);
+    std::nth_element(keys[0].begin(), last, keys[0].end());
+    last_key = last->first;
+    last_idx = last->second;
+}
+
+Minesweeper::Minesweeper(int rows, int cols, int mines, std::pmr::memory_resource* memory)
+    : rows(rows), cols(cols), mines(mines), is_mine_array(memory), is_opened_array(memory), mine_idxs(memory)
 {
+    set_num_threads(std::thread::hardware_concurrency());
+
     assert(rows >= MIN_ROWS);
     assert(cols >= MIN_COLS);
     assert(mines >= MIN_MINES);
@@ -77,23 +163,83 @@ Minesweeper::Minesweeper(int rows, int cols, int mines) : rows(rows), cols(cols)
         is_mine_array.emplace_back(cols);
         is_opened_array.emplace_back(cols);
     }
+}
 
-    reset();
+void Minesweeper::reset(unsigned seed)
+{
+    clear();
+    if (rows * cols < PARALLEL_MIN_CELLS) {
+        populate_mines(is_mine_array, mines, seed, mine_idxs);
+        return;
+    }
+
+    const MineSelector selector(rows * cols, mines, seed, num_threads);
+    for_each_row_band(rows, cols, num_threads, [&](int first_row, int end_row) {
+        for (int row = first_row; row < end_row; ++row) {
+            auto& is_mine_row = is_mine_array[row];
+            for (int col = 0; col < cols; ++col) {
+                if (selector.is_mine(static_cast<int64_t>(row) * cols + col)) {
+                    is_mine_row[col] = true;
+                }
+            }
+        }
+    });
+}
+
+void Minesweeper::reset_with_layout(const uint64_t* layout)
+{
+    clear();
+
+    // only visit the set bits
+    const int num_words = (rows * cols + 63) / 64;
+    for (int word = 0; word < num_words; ++word) {
+        for (uint64_t bits = layout[word]; bits != 0; bits &= bits - 1) {
+            const int idx = word * 64 + std::countr_zero(bits);
+            is_mine_array[idx / cols][idx % cols] = true;
+        }
+    }
+
+    // sanity check (0, 0) does not contain a mine
+    assert(!is_mine_array[0][0]);
 }
 
-void Minesweeper::reset()
+void Minesweeper::clear()
 {
     // initialize data
     active = true;
     num_opened = 0;
 
     // initialize arrays
-    for (int i = 0; i < rows; ++i) {
-        std::fill(is_mine_array[i].begin(), is_mine_array[i].end(), false);
-        std::fill(is_opened_array[i].begin(), is_opened_array[i].end(), false);
+    for_each_row_band(rows, cols, rows * cols < PARALLEL_MIN_CELLS ? 1 : num_threads, [&](int first_row, int end_row) {
+        for (int row = first_row; row < end_row; ++row) {
+            std::fill(is_mine_array[row].begin(), is_mine_array[row].end(), false);
+            std::fill(is_opened_array[row].begin(), is_opened_array[row].end(), false);
+        }
+    });
+}
+
+void Minesweeper::restore(
+    unsigned seed,
+    const std::optional<std::pair<int, int>>& first_opened,
+    const std::function<bool(int, int)>& is_opened)
+{
+    reset(seed);
+    if (!first_opened.has_value()) {
+        return;
     }
+    shift_mines(first_opened->first, first_opened->second);
 
-    populate_mines(is_mine_array, mines);
+    bool opened_mine = false;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (is_opened(row, col)) {
+                is_opened_array[row][col] = true;
+                ++num_opened;
+                opened_mine |= is_mine_array[row][col];
+            }
+        }
+    }
+    active = !opened_mine && !check_win();
 }
 
 bool Minesweeper::open(int row, int col, int& neighbor_mine_count)
@@ -103,13 +249,9 @@ bool Minesweeper::open(int row, int col, int& neighbor_mine_count)
     assert(0 <= col && col < cols);      // col must be valid
     assert(!is_opened_array[row][col]);  // cell must not be opened
 
-    // if first cell opened, guarantee no mine by shifting all cells down/right
-    // so that (0, 0) becomes the cell just clicked on
+    // if first cell opened, guarantee no mine
     if (num_opened == 0) {
-        std::rotate(is_mine_array.rbegin(), is_mine_array.rbegin() + row, is_mine_array.rend());
-        for (auto& is_mine_row : is_mine_array) {
-            std::rotate(is_mine_row.rbegin(), is_mine_row.rbegin() + col, is_mine_row.rend());
-        }
+        shift_mines(row, col);
     }
 
     // update state
@@ -138,6 +280,31 @@ bool Minesweeper::is_mine(int row, int col) const
     return is_mine_array[row][col];
 }
 
+std::vector<bool> Minesweeper::layout(int rows, int cols, int mines, unsigned seed, int first_row, int first_col)
+{
+    Minesweeper game(rows, cols, mines);
+    game.reset(seed);
+    game.shift_mines(first_row, first_col);
+
+    std::vector<bool> is_mine(rows * cols);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            is_mine[row * cols + col] = game.is_mine_array[row][col];
+        }
+    }
+    return is_mine;
+}
+
+void Minesweeper::shift_mines(int row, int col)
+{
+    std::rotate(is_mine_array.rbegin(), is_mine_array.rbegin() + row, is_mine_array.rend());
+    for_each_row_band(rows, cols, rows * cols < PARALLEL_MIN_CELLS ? 1 : num_threads, [&](int first_row, int end_row) {
+        for (int i = first_row; i < end_row; ++i) {
+            std::rotate(is_mine_array[i].rbegin(), is_mine_array[i].rbegin() + col, is_mine_array[i].rend());
+        }
+    });
+}
+
 int Minesweeper::count_neighbor_mines(int row, int col) const
 {
     int count = 0;
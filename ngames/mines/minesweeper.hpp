@@ -1,11 +1,113 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
+#include <random>
 #include <vector>
 
+#include <cassert>
+
 
 namespace ngames::mines
 {
 
+/**
+ * Randomly draw the cells containing mines. Cell 0 never contains a mine.
+ * Shared by everything that places mines from a seed, so that a seed always
+ * places the same mines.
+ * @param num_cells Number of cells.
+ * @param num_mines Number of mines to draw.
+ * @param seed Seed for the RNG.
+ * @param idxs Scratch list of indices, reused between calls to avoid allocating.
+ * @param on_mine Called with the index of each cell drawn, i.e. row * cols + col.
+ */
+template <typename Vector, typename F>
+void draw_mines(int num_cells, int num_mines, unsigned seed, Vector& idxs, F on_mine)
+{
+    // NOTE: we use a fixed RNG algorithm so that a seed places the same mines
+    // on every platform, e.g. when replaying a recorded game
+    std::mt19937 rng(seed);
+
+    // create list of indices
+    idxs.resize(num_cells);
+    std::iota(idxs.begin(), idxs.end(), 0);
+
+    // we draw indices at random to populate mines, removing drawn indices from
+    // the list to avoid drawing duplicates. we can remove an element in O(1)
+    // time by replacing it with the last element of the list. to guarantee
+    // index `0` not contain a mine, we remove it from the list.
+    idxs.front() = idxs.back();
+    idxs.pop_back();
+
+    // number of mines cannot be too large
+    assert(static_cast<int>(idxs.size()) >= num_mines);
+
+    for (int draw = 0; draw < num_mines; ++draw) {
+        // pick random index from the list
+        const int idx_idx = rng() % idxs.size();
+        on_mine(idxs[idx_idx]);
+        // remove drawn index from list
+        idxs[idx_idx] = idxs.back();
+        idxs.pop_back();
+    }
+}
+
+/**
+ * Random choice of the cells containing mines, for boards too large to draw
+ * them one by one with `draw_mines()`. Cell 0 never contains a mine.
+ *
+ * Each cell gets a random key from a counter-based RNG, i.e. a hash of the
+ * seed and the cell index, and the cells with the smallest keys contain mines.
+ * Whether a cell contains a mine is then a function of its index alone, which
+ * threads can evaluate on any part of the board, e.g. on bands of rows, so the
+ * mines do not depend on the number of threads.
+ */
+class MineSelector
+{
+public:
+    /**
+     * Find the key of the last cell containing a mine, on several threads.
+     * Takes two passes over the cells.
+     * @param num_cells Number of cells.
+     * @param num_mines Number of mines.
+     * @param seed Seed for the RNG.
+     * @param num_threads Number of threads.
+     */
+    MineSelector(int64_t num_cells, int64_t num_mines, unsigned seed, int num_threads);
+
+    inline bool is_mine(int64_t idx) const
+    {
+        if (idx == 0) {
+            return false;
+        }
+        const uint64_t key = get_key(idx);
+        return key < last_key || (key == last_key && idx <= last_idx);
+    }
+
+private:
+    /**
+     * Return the random key of a cell, i.e. the output of SplitMix64 for the
+     * seed at the cell index.
+     */
+    inline uint64_t get_key(int64_t idx) const
+    {
+        uint64_t z = seed_key + (static_cast<uint64_t>(idx) + 1) * 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t seed_key;
+    // Key and index of the last cell containing a mine, in order of key and
+    // then index, or an index of -1 if there are no mines.
+    uint64_t last_key;
+    int64_t last_idx;
+};
+
 /**
  * Back-end for the Minesweeper game. Contains secret game state hidden from
  * the player, i.e. the locations of all mines.
@@ -16,19 +118,52 @@ public:
     static constexpr int MIN_ROWS = 1;
     static constexpr int MIN_COLS = 1;
     static constexpr int MIN_MINES = 0;
+    // Boards with at least this many cells place their mines with a
+    // `MineSelector` on several threads, instead of with `draw_mines()`.
+    static constexpr int PARALLEL_MIN_CELLS = 1 << 24;
 
     /**
-     * Create back-end for new Minesweeper game.
+     * Create back-end for new Minesweeper game. Call `reset()` to place the
+     * mines before opening any cells.
      * @param rows Number of rows.
      * @param cols Number of columns.
      * @param mines Number of mines.
+     * @param memory Memory resource for the allocations of the back-end, e.g. an arena.
      */
-    Minesweeper(int rows, int cols, int mines);
+    Minesweeper(int rows, int cols, int mines, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     /**
      * Reset the game.
+     * @param seed Seed determining the locations of the mines. Together with
+     * the first cell opened, it fully determines the game.
      */
-    void reset();
+    void reset(unsigned seed);
+
+    /**
+     * Reset the game with mines placed from a precomputed layout, e.g. from a
+     * corpus, instead of drawing them from a seed.
+     * @param layout Bit `i` of word `i / 64` is set if cell `i` contains a
+     * mine, in reading order. Cell 0 must not contain a mine.
+     */
+    void reset_with_layout(const uint64_t* layout);
+
+    /**
+     * Set number of threads used to reset boards with at least
+     * `PARALLEL_MIN_CELLS` cells. The mines placed do not depend on it.
+     * @param num_threads Number of threads, by default the number of cores.
+     */
+    inline void set_num_threads(int num_threads) { this->num_threads = std::max(num_threads, 1); }
+
+    /**
+     * Restore a game in progress.
+     * @param seed Seed the game was reset with.
+     * @param first_opened (row, column) of first opened cell, if any.
+     * @param is_opened Returns whether the cell (row, column) has been opened.
+     */
+    void restore(
+        unsigned seed,
+        const std::optional<std::pair<int, int>>& first_opened,
+        const std::function<bool(int, int)>& is_opened);
 
     /**
      * Open a cell. First cell opened is guaranteed to not contain a mine.
@@ -55,7 +190,34 @@ public:
      */
     bool is_mine(int row, int col) const;
 
+    /**
+     * Place mines as resetting with a seed and then opening a cell would, and
+     * return the locations of all mines. Used to resolve moves outside of the
+     * back-end, e.g. from several threads at once.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     * @param seed Seed determining the locations of the mines.
+     * @param first_row Row of first opened cell.
+     * @param first_col Column of first opened cell.
+     * @returns Whether each cell contains a mine, in reading order.
+     */
+    static std::vector<bool> layout(int rows, int cols, int mines, unsigned seed, int first_row, int first_col);
+
 private:
+    /**
+     * Mark all cells as unopened and without mines.
+     */
+    void clear();
+
+    /**
+     * Shift all cells down/right so that (0, 0) becomes the given cell. Since
+     * (0, 0) never contains a mine, this guarantees the given cell does not.
+     * @param row Cell row.
+     * @param col Cell column.
+     */
+    void shift_mines(int row, int col);
+
     /**
      * Returns true if player win condition has been met, i.e. all non-mine
      * cells have been opened.
@@ -77,11 +239,16 @@ private:
     bool active;
     // Number of opened cells.
     int num_opened;
+    // Number of threads used on boards with at least `PARALLEL_MIN_CELLS`
+    // cells.
+    int num_threads;
 
     // Array with shape (rows, cols) tracking which cells contain a mine.
-    std::vector<std::vector<bool>> is_mine_array;
+    std::pmr::vector<std::pmr::vector<bool>> is_mine_array;
     // Array with shape (rows, cols) tracking which cells have been opened.
-    std::vector<std::vector<bool>> is_opened_array;
+    std::pmr::vector<std::pmr::vector<bool>> is_opened_array;
+    // Scratch list of cell indices used to place mines.
+    std::pmr::vector<int> mine_idxs;
 };
 
 }  // namespace ngames::mines
@@ -0,0 +1,67 @@
+#include <ngames/mines/minimap.hpp>
+
+#include <ngames/mines/ui.hpp>
+
+#include <algorithm>
+
+
+namespace ngames::mines
+{
+
+Minimap::Minimap(const Board& board, int start_y, int start_x, WINDOW* border_window)
+    : Component(subwin(border_window, rows_for(board.rows), cols_for(board.cols), start_y, start_x)),
+      rows(rows_for(board.rows)),
+      cols(cols_for(board.cols)),
+      board(board)
+{
+}
+
+int Minimap::rows_for(int board_rows)
+{
+    // each character covers at least one tile, so every region contains a tile
+    return std::clamp(board_rows / Summary::TILE_SIZE, 1, MAX_ROWS);
+}
+
+int Minimap::cols_for(int board_cols)
+{
+    return std::clamp(board_cols / Summary::TILE_SIZE, 1, MAX_COLS);
+}
+
+void Minimap::refresh() const
+{
+    const Summary& summary = board.get_summary();
+    const int level = summary.level_for(board.rows / rows, board.cols / cols);
+
+    werase(window);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const auto counts = summary.query(
+                row * board.rows / rows,
+                col * board.cols / cols,
+                (row + 1) * board.rows / rows,
+                (col + 1) * board.cols / cols,
+                level);
+
+            wmove(window, row, col);
+            if (counts.opened + counts.flagged == counts.cells) {
+                // solved; every cell is opened or flagged
+                waddch(window, '.');
+            } else if (counts.opened > 0) {
+                waddch(window, '+');
+            } else if (counts.flagged > 0) {
+                constexpr auto attr = A_BOLD;
+                wattron(window, attr);
+                waddch(window, 'F');
+                wattroff(window, attr);
+            } else {
+                constexpr auto attr = COLOR_PAIR(COLOR_PAIR_UNOPENED);
+                wattron(window, attr);
+                waddch(window, '#');
+                wattroff(window, attr);
+            }
+        }
+    }
+    wnoutrefresh(window);
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ngames/mines/board.hpp>
+
+#include <ngames/common/component.hpp>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Scaled-down overview of a large board. Each character summarizes a region of
+ * cells as solved, open, flagged or untouched. Drawing reads the board's
+ * `Summary` rather than its cells, so takes time proportional to the size of
+ * the minimap.
+ */
+class Minimap : public Component
+{
+public:
+    static constexpr int MAX_ROWS = 16;
+    static constexpr int MAX_COLS = 32;
+
+    /**
+     * Create minimap.
+     * @param board Reference to board object.
+     * @param start_y y-coordinate of the top-left corner of the window.
+     * @param start_x x-coordinate of the top-left corner of the window.
+     * @param border_window Parent window containing border.
+     */
+    Minimap(const Board& board, int start_y, int start_x, WINDOW* border_window);
+
+    /**
+     * Refresh the window displaying the minimap.
+     */
+    void refresh() const override;
+
+    /**
+     * Return number of rows of the minimap for a board.
+     * @param board_rows Number of rows of the board.
+     */
+    static int rows_for(int board_rows);
+
+    /**
+     * Return number of columns of the minimap for a board.
+     * @param board_cols Number of columns of the board.
+     */
+    static int cols_for(int board_cols);
+
+    /**
+     * Returns true if the board is large enough to warrant a minimap.
+     * @param board_rows Number of rows of the board.
+     * @param board_cols Number of columns of the board.
+     */
+    static inline bool is_needed(int board_rows, int board_cols)
+    {
+        return board_rows > MAX_ROWS || board_cols > MAX_COLS;
+    }
+
+    const int rows;
+    const int cols;
+
+private:
+    const Board& board;
+};
+
+}  // namespace ngames::mines
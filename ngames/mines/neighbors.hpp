@@ -1,12 +1,24 @@
 #pragma once
 
 #include <array>
-#include <vector>
+#include <utility>
 
 
 namespace ngames::mines
 {
 
+/**
+ * Fixed-capacity list of the neighbors of a cell. Lives on the stack, so
+ * iterating neighbors never allocates.
+ */
+struct Neighbors {
+    std::array<std::pair<int, int>, 8> cells;
+    int size = 0;
+
+    inline const std::pair<int, int>* begin() const { return cells.data(); }
+    inline const std::pair<int, int>* end() const { return cells.data() + size; }
+};
+
 /**
  * Convenience function for iterating the neighbors of a cell.
  * @param row Cell row.
@@ -15,26 +27,18 @@ namespace ngames::mines
  * @param num_cols Number of columns.
  * @returns List of (nb_row, nb_col).
  */
-inline std::vector<std::pair<int, int>> get_neighbors(int row, int col, int num_rows, int num_cols)
+inline Neighbors get_neighbors(int row, int col, int num_rows, int num_cols)
 {
-    std::array<std::pair<int, int>, 8> neighbor_candidates;
-    neighbor_candidates[0] = {row - 1, col - 1};
-    neighbor_candidates[1] = {row - 1, col};
-    neighbor_candidates[2] = {row - 1, col + 1};
-    neighbor_candidates[3] = {row, col - 1};
-    neighbor_candidates[4] = {row, col + 1};
-    neighbor_candidates[5] = {row + 1, col - 1};
-    neighbor_candidates[6] = {row + 1, col};
-    neighbor_candidates[7] = {row + 1, col + 1};
-
-    // filter out those outside the bounds
-    std::vector<std::pair<int, int>> neighbors;
-    for (const auto& [nb_row, nb_col] : neighbor_candidates) {
-        if (nb_row >= 0 && nb_row < num_rows && nb_col >= 0 && nb_col < num_cols) {
-            neighbors.emplace_back(nb_row, nb_col);
+    Neighbors neighbors;
+    for (int nb_row = row - 1; nb_row <= row + 1; ++nb_row) {
+        for (int nb_col = col - 1; nb_col <= col + 1; ++nb_col) {
+            // filter out the cell itself and those outside the bounds
+            if ((nb_row != row || nb_col != col) && nb_row >= 0 && nb_row < num_rows && nb_col >= 0 &&
+                nb_col < num_cols) {
+                neighbors.cells[neighbors.size++] = {nb_row, nb_col};
+            }
         }
     }
-
     return neighbors;
 }
 
@@ -0,0 +1,176 @@
+#include <ngames/mines/replay.hpp>
+
+#include <cassert>
+#include <climits>
+#include <cstring>
+
+
+namespace
+{
+
+constexpr char MAGIC[4] = {'M', 'N', 'R', 'P'};
+constexpr uint8_t VERSION = 1;
+
+// Number of low bits of an event's first varint holding the action.
+constexpr int ACTION_BITS = 2;
+
+inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+int apply_event(Game& game, const ReplayEvent& event)
+{
+    switch (event.action) {
+        case ReplayEvent::Action::click:
+            return game.click_cell(event.row, event.col);
+        case ReplayEvent::Action::flag:
+            return game.toggle_flag(event.row, event.col);
+        case ReplayEvent::Action::reset:
+            game.reset(event.seed);
+            return 0;
+    }
+    assert(false);
+    return 0;
+}
+
+ReplayWriter::ReplayWriter(FILE* file, const ReplayHeader& header)
+    : file(file),
+      cols(header.cols),
+      last_time_ms(0),
+      last_idx(0)
+{
+    fwrite(MAGIC, 1, sizeof(MAGIC), file);
+    fputc(VERSION, file);
+    put_varint(header.rows);
+    put_varint(header.cols);
+    put_varint(header.mines);
+    put_varint(header.seed);
+    fflush(file);
+}
+
+void ReplayWriter::write(const ReplayEvent& event)
+{
+    assert(event.time_ms >= last_time_ms);  // events must be in order
+
+    put_varint(((event.time_ms - last_time_ms) << ACTION_BITS) | event.action);
+    last_time_ms = event.time_ms;
+
+    if (event.action == ReplayEvent::Action::reset) {
+        put_varint(event.seed);
+    } else {
+        const int64_t idx = static_cast<int64_t>(event.row) * cols + event.col;
+        put_varint(zigzag_encode(idx - last_idx));
+        last_idx = idx;
+    }
+    // events are written at human speed, so flush to avoid losing them on a crash
+    fflush(file);
+}
+
+void ReplayWriter::put_varint(uint64_t value)
+{
+    while (value >= 0x80) {
+        fputc(static_cast<int>(value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+    fputc(static_cast<int>(value), file);
+}
+
+ReplayReader::ReplayReader(FILE* file) : file(file), rows(0), cols(0), last_time_ms(0), last_idx(0) {}
+
+bool ReplayReader::read_header(ReplayHeader& header)
+{
+    char magic[sizeof(MAGIC)];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    if (fgetc(file) != VERSION) {
+        return false;
+    }
+
+    uint64_t rows, cols, mines, seed;
+    if (!get_varint(rows) || !get_varint(cols) || !get_varint(mines) || !get_varint(seed)) {
+        return false;
+    }
+    if (rows > INT_MAX || cols > INT_MAX || mines > INT_MAX || seed > UINT_MAX) {
+        return false;
+    }
+    header = {
+        .rows = static_cast<int>(rows),
+        .cols = static_cast<int>(cols),
+        .mines = static_cast<int>(mines),
+        .seed = static_cast<unsigned>(seed),
+    };
+    this->rows = header.rows;
+    this->cols = header.cols;
+    return true;
+}
+
+bool ReplayReader::read_event(ReplayEvent& event)
+{
+    uint64_t tag;
+    if (!get_varint(tag)) {
+        return false;
+    }
+    last_time_ms += tag >> ACTION_BITS;
+    event.time_ms = last_time_ms;
+
+    const uint64_t action = tag & ((1 << ACTION_BITS) - 1);
+    switch (action) {
+        case ReplayEvent::Action::click:
+        case ReplayEvent::Action::flag: {
+            uint64_t delta;
+            if (!get_varint(delta)) {
+                return false;
+            }
+            last_idx += zigzag_decode(delta);
+            if (last_idx < 0 || last_idx >= static_cast<int64_t>(rows) * cols) {
+                return false;
+            }
+            event.action = static_cast<ReplayEvent::Action>(action);
+            event.row = static_cast<int>(last_idx / cols);
+            event.col = static_cast<int>(last_idx % cols);
+            return true;
+        }
+        case ReplayEvent::Action::reset: {
+            uint64_t seed;
+            if (!get_varint(seed)) {
+                return false;
+            }
+            event.action = ReplayEvent::Action::reset;
+            event.seed = static_cast<unsigned>(seed);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool ReplayReader::get_varint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = fgetc(file);
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace ngames::mines
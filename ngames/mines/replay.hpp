@@ -0,0 +1,125 @@
+#pragma once
+
+#include <ngames/mines/game.hpp>
+
+#include <cstdint>
+#include <cstdio>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Parameters of a recorded Minesweeper session.
+ */
+struct ReplayHeader {
+    int rows;
+    int cols;
+    int mines;
+    // Seed of the first game.
+    unsigned seed;
+};
+
+/**
+ * Player action recorded in a replay.
+ */
+struct ReplayEvent {
+    enum Action : uint8_t { click, flag, reset };
+
+    // Milliseconds since the start of the recording.
+    uint64_t time_ms;
+    Action action;
+    // Cell row, for `click` and `flag`.
+    int row;
+    // Cell column, for `click` and `flag`.
+    int col;
+    // Seed of the new game, for `reset`.
+    unsigned seed;
+};
+
+/**
+ * Apply a recorded action to a game.
+ * @param game Game.
+ * @param event Recorded action.
+ * @returns Return code of the action. See `Game` for details.
+ */
+int apply_event(Game& game, const ReplayEvent& event);
+
+/**
+ * Writes a Minesweeper session as a compact binary log.
+ *
+ * The log starts with the magic bytes "MNRP", a version byte, and then the
+ * header fields as varints. Each event follows as a varint of
+ * `(time delta << 2) | action`, and then either the zigzag varint delta of
+ * the cell index (row * cols + col) from the previous event, or the varint
+ * seed of the new game. Since players mostly act near where they last acted,
+ * a typical event takes 2-3 bytes.
+ */
+class ReplayWriter
+{
+public:
+    /**
+     * Create writer, and write the header.
+     * @param file File to write to. Must stay open while the writer is used.
+     * @param header Session parameters.
+     */
+    ReplayWriter(FILE* file, const ReplayHeader& header);
+
+    /**
+     * Write an event. Events must be written in order of time.
+     * @param event Event.
+     */
+    void write(const ReplayEvent& event);
+
+private:
+    void put_varint(uint64_t value);
+
+    FILE* const file;
+    const int cols;
+
+    // Time of the previous event.
+    uint64_t last_time_ms;
+    // Cell index of the previous click or flag.
+    int64_t last_idx;
+};
+
+/**
+ * Reads a Minesweeper session written by `ReplayWriter`.
+ */
+class ReplayReader
+{
+public:
+    /**
+     * Create reader.
+     * @param file File to read from. Must stay open while the reader is used.
+     */
+    ReplayReader(FILE* file);
+
+    /**
+     * Read the header. Must be called once before reading events.
+     * @param header Set to the session parameters.
+     * @returns False if the file is not a valid replay.
+     */
+    bool read_header(ReplayHeader& header);
+
+    /**
+     * Read the next event.
+     * @param event Set to the next event.
+     * @returns False at the end of the file, or if the file is corrupt.
+     */
+    bool read_event(ReplayEvent& event);
+
+private:
+    bool get_varint(uint64_t& value);
+
+    FILE* const file;
+    int rows;
+    int cols;
+
+    // Time of the previous event.
+    uint64_t last_time_ms;
+    // Cell index of the previous click or flag.
+    int64_t last_idx;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,169 @@
+#include <ngames/mines/shared_board.hpp>
+
+#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/neighbors.hpp>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+SharedBoard::SharedBoard(int rows, int cols, int mines)
+    : rows(rows),
+      cols(cols),
+      mines(mines),
+      seed(0),
+      placed(false),
+      neighbor_mine_counts(rows * cols),
+      state(Game::State::active),
+      num_opened(0),
+      cells(rows * cols)
+{
+}
+
+void SharedBoard::reset(unsigned seed)
+{
+    this->seed = seed;
+    placed = false;
+    state = Game::State::active;
+    num_opened = 0;
+    for (auto& cell : cells) {
+        cell = 0;
+    }
+}
+
+void SharedBoard::place_mines(int row, int col)
+{
+    std::lock_guard<std::mutex> lock(place_mutex);
+    // another player may have clicked first
+    if (placed.load()) {
+        return;
+    }
+
+    is_mine = Minesweeper::layout(rows, cols, mines, seed, row, col);
+    for (int idx = 0; idx < rows * cols; ++idx) {
+        int count = 0;
+        for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+            count += is_mine[nb_row * cols + nb_col];
+        }
+        neighbor_mine_counts[idx] = count;
+    }
+    placed.store(true);
+}
+
+int SharedBoard::click_cell(int row, int col, std::vector<int>& changes)
+{
+    assert(0 <= row && row < rows);  // row must be valid
+    assert(0 <= col && col < cols);  // col must be valid
+
+    if (state.load() != Game::State::active) {
+        return 1;
+    }
+
+    const int idx = row * cols + col;
+    const Cell cell = cells[idx].load();
+    if (cell & CELL_FLAGGED) {
+        return 3;
+    }
+
+    const size_t begin = changes.size();
+    if (!(cell & CELL_OPENED)) {
+        if (!placed.load()) {
+            place_mines(row, col);
+        }
+        // another player may have opened or flagged the cell in the meantime
+        if (!open(idx, changes)) {
+            return 2;
+        }
+    } else {
+        // chord if the number of neighboring flags equals the number of
+        // neighboring mines
+        int num_flags = 0;
+        int num_unopened = 0;
+        for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+            const Cell nb_cell = cells[nb_row * cols + nb_col].load();
+            num_flags += (nb_cell & CELL_FLAGGED) != 0;
+            num_unopened += (nb_cell & CELL_OPENED) == 0;
+        }
+        if (num_unopened == 0 || num_flags != (cell & CELL_COUNT_MASK)) {
+            return 2;
+        }
+        for (const auto& [nb_row, nb_col] : get_neighbors(row, col, rows, cols)) {
+            open(nb_row * cols + nb_col, changes);
+        }
+    }
+
+    flood_fill(changes, begin);
+    return 0;
+}
+
+int SharedBoard::toggle_flag(int row, int col, std::vector<int>& changes)
+{
+    assert(0 <= row && row < rows);  // row must be valid
+    assert(0 <= col && col < cols);  // col must be valid
+
+    if (state.load() != Game::State::active) {
+        return 1;
+    }
+
+    const int idx = row * cols + col;
+    Cell cell = cells[idx].load();
+    do {
+        if (cell & CELL_OPENED) {
+            return 2;
+        }
+    } while (!cells[idx].compare_exchange_weak(cell, cell ^ CELL_FLAGGED));
+
+    changes.push_back(idx);
+    return 0;
+}
+
+bool SharedBoard::open(int idx, std::vector<int>& changes)
+{
+    Cell cell = cells[idx].load();
+    do {
+        if (cell & (CELL_OPENED | CELL_FLAGGED)) {
+            return false;
+        }
+    } while (!cells[idx].compare_exchange_weak(cell, cell | CELL_OPENED | neighbor_mine_counts[idx]));
+    changes.push_back(idx);
+
+    if (is_mine[idx]) {
+        end_game(Game::State::lose, changes);
+    } else if (num_opened.fetch_add(1) + 1 + mines == rows * cols) {
+        end_game(Game::State::win, changes);
+    }
+    return true;
+}
+
+void SharedBoard::flood_fill(std::vector<int>& changes, size_t begin)
+{
+    // NOTE: `changes` grows while we iterate it, so we cannot hold iterators
+    for (size_t i = begin; i < changes.size(); ++i) {
+        const int idx = changes[i];
+        if (is_mine[idx] || neighbor_mine_counts[idx] != 0 || state.load() != Game::State::active) {
+            continue;
+        }
+        for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+            open(nb_row * cols + nb_col, changes);
+        }
+    }
+}
+
+void SharedBoard::end_game(Game::State end_state, std::vector<int>& changes)
+{
+    Game::State expected = Game::State::active;
+    // only the first player to end the game reveals the mines
+    if (!state.compare_exchange_strong(expected, end_state)) {
+        return;
+    }
+    for (int idx = 0; idx < rows * cols; ++idx) {
+        if (is_mine[idx]) {
+            cells[idx].fetch_or(CELL_KNOWN_MINE);
+            changes.push_back(idx);
+        }
+    }
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <ngames/mines/cell.hpp>
+#include <ngames/mines/game.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Minesweeper game that several threads can play at once, e.g. one per player
+ * of a co-op session.
+ *
+ * Cells are packed bytes updated with atomic compare-and-swap, so moves on
+ * different cells never wait for each other, and a flood fill only contends
+ * with moves on the cells it opens. Only placing the mines on the first click
+ * takes a lock. The outcome of a move is reported as the list of cells it
+ * changed, so that only deltas need to be sent to the players.
+ */
+class SharedBoard
+{
+public:
+    /**
+     * Create board.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     */
+    SharedBoard(int rows, int cols, int mines);
+
+    /**
+     * Reset the game. Must not be called while other threads are playing.
+     * @param seed Seed determining the locations of the mines.
+     */
+    void reset(unsigned seed);
+
+    /**
+     * Click on a cell, opening it or chording it. See `Game::click_cell()`.
+     *
+     * @param row Cell row.
+     * @param col Cell column.
+     * @param changes Cells changed by the click are appended to this.
+     * NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+     *
+     * @returns Return code. A non-zero value means that an error occurred and
+     * the game state was not been changed. The possible error codes are
+     *   1: game is inactive.
+     *   2: cell has already been opened, and cannot be chorded.
+     *   3: cell has been flagged.
+     */
+    int click_cell(int row, int col, std::vector<int>& changes);
+
+    /**
+     * Toggle the flag for a cell.
+     *
+     * @param row Cell row.
+     * @param col Cell column.
+     * @param changes Cell is appended to this if it changed.
+     *
+     * @returns Return code. A non-zero value means that an error occurred and
+     * the game state was not been changed. The possible error codes are
+     *   1: game is inactive.
+     *   2: cell has already been opened.
+     */
+    int toggle_flag(int row, int col, std::vector<int>& changes);
+
+    inline Game::State get_state() const { return state.load(); }
+
+    /**
+     * Return current state of a cell.
+     * @param idx Cell index, i.e. row * cols + col.
+     */
+    inline Cell get_cell(int idx) const { return cells[idx].load(); }
+
+    const int rows;
+    const int cols;
+    const int mines;
+
+private:
+    /**
+     * Place the mines, unless already placed, so that the given cell does not
+     * contain a mine.
+     * @param row Row of first opened cell.
+     * @param col Column of first opened cell.
+     */
+    void place_mines(int row, int col);
+
+    /**
+     * Open a cell, unless it is already opened or flagged.
+     * @param idx Cell index.
+     * @param changes Changed cells are appended to this.
+     * @returns Whether this call opened the cell.
+     */
+    bool open(int idx, std::vector<int>& changes);
+
+    /**
+     * Open the neighbors of all cells without neighboring mines, starting at
+     * `changes[begin]` and including cells opened along the way. Uses
+     * `changes` as the work list, so it never recurses.
+     * @param changes Changed cells.
+     * @param begin Index of the first cell in `changes` to expand.
+     */
+    void flood_fill(std::vector<int>& changes, size_t begin);
+
+    /**
+     * End the game, unless it has already ended, and reveal all mines.
+     * @param end_state Either `win` or `lose`.
+     * @param changes Changed cells are appended to this.
+     */
+    void end_game(Game::State end_state, std::vector<int>& changes);
+
+    // Seed used to place the mines.
+    unsigned seed;
+
+    // Whether the mines have been placed.
+    std::atomic<bool> placed;
+    // Guards placing the mines.
+    std::mutex place_mutex;
+    // Whether each cell contains a mine, in reading order.
+    std::vector<bool> is_mine;
+    // Number of neighboring mines of each cell, in reading order.
+    std::vector<uint8_t> neighbor_mine_counts;
+
+    std::atomic<Game::State> state;
+    // Number of opened cells that do not contain a mine.
+    std::atomic<int> num_opened;
+
+    // Array with shape (rows, cols) tracking the state of each cell.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::vector<std::atomic<Cell>> cells;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,753 @@
+#include <ngames/mines/solver.hpp>
+
+#include <ngames/mines/neighbors.hpp>
+#include <ngames/mines/zobrist.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <cassert>
+
+
+namespace
+{
+
+// Binomial coefficients C(n, k) for n <= 8, the most cells in a group.
+constexpr auto BINOMIALS = [] {
+    std::array<std::array<double, 9>, 9> table = {};
+    for (int n = 0; n <= 8; ++n) {
+        table[n][0] = 1;
+        for (int k = 1; k <= n; ++k) {
+            table[n][k] = table[n - 1][k - 1] + (k <= n - 1 ? table[n - 1][k] : 0);
+        }
+    }
+    return table;
+}();
+
+/**
+ * Scale values so that the largest is one, to keep products of many of them
+ * within the range of doubles. Probabilities are ratios of sums of such
+ * products, so the scale factors cancel out.
+ * @param values Non-negative values.
+ */
+void normalize(std::vector<double>& values)
+{
+    const double max = *std::max_element(values.begin(), values.end());
+    if (max > 0) {
+        for (double& value : values) {
+            value /= max;
+        }
+    }
+}
+
+/**
+ * Return element `i` of a vector, or zero if out of bounds.
+ */
+inline double at(const std::vector<double>& values, int i)
+{
+    return i >= 0 && i < static_cast<int>(values.size()) ? values[i] : 0.0;
+}
+
+/**
+ * Return an element of a vector, reusing a previously cleared element if the
+ * vector has one, to keep the memory of its members.
+ * @param values Vector.
+ * @param size Number of elements in use, incremented.
+ */
+template <typename T>
+T& next_element(std::vector<T>& values, int& size)
+{
+    if (size == static_cast<int>(values.size())) {
+        values.emplace_back();
+    }
+    return values[size++];
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+Solver::Solver(int num_threads, Cache* cache)
+    : pool(num_threads), cache(cache), scratches(num_threads), interrupt(nullptr), num_components(0), num_tasks(0)
+{
+}
+
+void Solver::analyze(const Game& game, Analysis& analysis, const Interrupt* interrupt)
+{
+    this->interrupt = interrupt;
+    find_components(game);
+
+    // reuse the enumerations of components seen before
+    for (int c = 0; c < num_components; ++c) {
+        Component& component = components[c];
+        component.cached = false;
+        component.interrupted = false;
+        if (cache == nullptr || component.result.estimated) {
+            continue;
+        }
+        if (const auto result = cache->find(component.key)) {
+            component.result = *result;
+            component.cached = true;
+        }
+    }
+
+    // enumerate components, largest first so they do not finish last
+    num_tasks = 0;
+    prefixes.clear();
+    for (int c = 0; c < num_components; ++c) {
+        plan_tasks(c);
+    }
+    task_order.resize(num_tasks);
+    std::iota(task_order.begin(), task_order.end(), 0);
+    std::stable_sort(task_order.begin(), task_order.end(), [this](int a, int b) {
+        return components[tasks[a].component].num_groups > components[tasks[b].component].num_groups;
+    });
+    pool.run(num_tasks, [this](int i, int thread) { search(tasks[task_order[i]], scratches[thread]); });
+    pool.run(num_components, [this](int c, int) {
+        Component& component = components[c];
+        if (component.cached || component.num_tasks == 0) {
+            return;
+        }
+        merge_tasks(component);
+        if (cache != nullptr && !component.interrupted) {
+            cache->insert(component.key, std::make_shared<const Result>(component.result));
+        }
+    });
+
+    analysis.probabilities.assign(game.rows * game.cols, 0.0);
+    analysis.safe_cells.clear();
+    analysis.mine_cells.clear();
+    analysis.num_components = num_components;
+    analysis.num_estimated = 0;
+    analysis.interrupted = false;
+    for (int c = 0; c < num_components; ++c) {
+        const Component& component = components[c];
+        if (component.result.estimated) {
+            estimate(component, analysis);
+            ++analysis.num_estimated;
+        }
+        analysis.interrupted = analysis.interrupted || component.interrupted;
+    }
+    combine(game, analysis);
+
+    std::sort(analysis.safe_cells.begin(), analysis.safe_cells.end());
+    std::sort(analysis.mine_cells.begin(), analysis.mine_cells.end());
+}
+
+void Solver::find_components(const Game& game)
+{
+    const int rows = game.rows;
+    const int cols = game.cols;
+    const auto& cells = game.get_cells();
+    const auto is_opened = [&](int idx) { return (cells[idx] & CELL_OPENED) != 0; };
+    const auto has_unopened_neighbor = [&](int idx) {
+        for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+            if (!is_opened(nb_row * cols + nb_col)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // NOTE: unvisited cells are -1, and cells visited by the current search
+    // are -2 until they are assigned a group or constraint
+    constexpr int VISITED = -2;
+    cell_index.assign(rows * cols, -1);
+    num_components = 0;
+    groups.clear();
+    constraints.clear();
+    group_cells.clear();
+    group_constraints.clear();
+    int num_grouped_cells = 0;
+
+    // cells of the current component in search order: opened cells become
+    // constraints and unopened cells are sorted into groups
+    std::vector<int>& order = component_order;
+    // (constraints of the cell, position in `order`) for each unopened cell
+    std::vector<std::pair<std::array<int, 8>, int>>& keys = component_keys;
+
+    for (int start = 0; start < rows * cols; ++start) {
+        if (cell_index[start] != -1 || !is_opened(start) || !has_unopened_neighbor(start)) {
+            continue;
+        }
+
+        // breadth-first search alternating between opened and unopened cells,
+        // hashing the shape of the component relative to its first cell
+        Component& component = next_element(components, num_components);
+        component.key = {.hash = 0, .check = 0};
+        order.assign(1, start);
+        cell_index[start] = VISITED;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const int idx = order[i];
+            const bool opened = is_opened(idx);
+            // NOTE: states are offset by one since state 0 has key 0
+            const Cell state = opened ? (cells[idx] & CELL_COUNT_MASK) + 1 : CELL_OPENED;
+            const uint64_t position = static_cast<uint64_t>(idx / cols - start / cols) << 32 |
+                                      static_cast<uint32_t>(idx % cols - start % cols);
+            component.key.hash ^= zobrist_key(position, state, 0);
+            component.key.check ^= zobrist_key(position, state, 1);
+            for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+                const int nb_idx = nb_row * cols + nb_col;
+                // opened cells link unopened ones, and the reverse
+                if (cell_index[nb_idx] == -1 && is_opened(nb_idx) != opened) {
+                    cell_index[nb_idx] = VISITED;
+                    order.push_back(nb_idx);
+                }
+            }
+        }
+
+        component.first_group = static_cast<int>(groups.size());
+        component.first_constraint = static_cast<int>(constraints.size());
+        component.num_cells = 0;
+
+        // constraints
+        for (const int idx : order) {
+            if (!is_opened(idx)) {
+                continue;
+            }
+            Constraint constraint = {.value = cells[idx] & CELL_COUNT_MASK, .size = 0};
+            for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+                constraint.size += !is_opened(nb_row * cols + nb_col);
+            }
+            cell_index[idx] = static_cast<int>(constraints.size());
+            constraints.push_back(constraint);
+        }
+        component.num_constraints = static_cast<int>(constraints.size()) - component.first_constraint;
+
+        // cells next to the same constraints form a group; groups are ordered
+        // by their first cell in search order, so neighboring groups are
+        // searched one after the other
+        keys.clear();
+        for (size_t i = 0; i < order.size(); ++i) {
+            const int idx = order[i];
+            if (is_opened(idx)) {
+                continue;
+            }
+            std::array<int, 8> key;
+            key.fill(-1);
+            int num_keys = 0;
+            for (const auto& [nb_row, nb_col] : get_neighbors(idx / cols, idx % cols, rows, cols)) {
+                const int nb_idx = nb_row * cols + nb_col;
+                if (!is_opened(nb_idx)) {
+                    continue;
+                }
+                // insertion sort, since there are at most 8
+                int pos = num_keys++;
+                for (; pos > 0 && key[pos - 1] > cell_index[nb_idx]; --pos) {
+                    key[pos] = key[pos - 1];
+                }
+                key[pos] = cell_index[nb_idx];
+            }
+            keys.emplace_back(key, static_cast<int>(i));
+        }
+        std::sort(keys.begin(), keys.end());
+
+        // first cell of each group in `keys`, sorted by search order
+        std::vector<int>& group_starts = component_group_starts;
+        group_starts.clear();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (i == 0 || keys[i].first != keys[i - 1].first) {
+                group_starts.push_back(static_cast<int>(i));
+            }
+        }
+        std::sort(group_starts.begin(), group_starts.end(), [&](int a, int b) { return keys[a].second < keys[b].second; });
+
+        for (const int group_start : group_starts) {
+            const auto& key = keys[group_start].first;
+            Group group = {
+                .size = 0,
+                .first_cell = static_cast<int>(group_cells.size()),
+                .first_constraint = static_cast<int>(group_constraints.size()),
+                .num_constraints = 0,
+            };
+            for (size_t i = group_start; i < keys.size() && keys[i].first == key; ++i) {
+                const int idx = order[keys[i].second];
+                cell_index[idx] = static_cast<int>(groups.size());
+                group_cells.push_back(idx);
+                ++group.size;
+            }
+            for (int i = 0; i < 8 && key[i] >= 0; ++i) {
+                group_constraints.push_back(key[i]);
+                ++group.num_constraints;
+            }
+            component.num_cells += group.size;
+            groups.push_back(group);
+        }
+        component.num_groups = static_cast<int>(groups.size()) - component.first_group;
+        component.result.estimated = component.num_groups > MAX_GROUPS;
+        num_grouped_cells += component.num_cells;
+    }
+
+    num_other_cells = rows * cols - game.get_num_opened() - num_grouped_cells;
+}
+
+void Solver::plan_tasks(int c)
+{
+    Component& component = components[c];
+    component.first_task = num_tasks;
+    component.num_tasks = 0;
+    if (component.result.estimated || component.cached) {
+        return;
+    }
+
+    // split large components on every combination of mines in their first
+    // groups; combinations breaking constraints end their task immediately
+    const int depth = component.num_groups >= SPLIT_GROUPS ? SPLIT_DEPTH : 0;
+    std::array<int, SPLIT_DEPTH> prefix = {};
+    while (true) {
+        Task& task = next_element(tasks, num_tasks);
+        task.component = c;
+        task.first_prefix = static_cast<int>(prefixes.size());
+        task.prefix_size = depth;
+        prefixes.insert(prefixes.end(), prefix.begin(), prefix.begin() + depth);
+        ++component.num_tasks;
+
+        // next combination, counting with the group sizes as bases
+        int d = depth - 1;
+        while (d >= 0 && prefix[d] == groups[component.first_group + d].size) {
+            prefix[d] = 0;
+            --d;
+        }
+        if (d < 0) {
+            break;
+        }
+        ++prefix[d];
+    }
+}
+
+void Solver::search(Task& task, Scratch& scratch) const
+{
+    const Component& component = components[task.component];
+    const int num_groups = component.num_groups;
+    const Group* const task_groups = groups.data() + component.first_group;
+    const Constraint* const task_constraints = constraints.data() + component.first_constraint;
+
+    task.counts.assign(component.num_cells + 1, 0.0);
+    task.group_mines.assign((component.num_cells + 1) * num_groups, 0.0);
+    task.maybe_mine.assign(num_groups, false);
+    task.always_mine.assign(num_groups, true);
+    task.aborted = false;
+    task.interrupted = false;
+
+    auto& mines = scratch.mines;
+    auto& free = scratch.free;
+    auto& k = scratch.k;
+    auto& hi = scratch.hi;
+    auto& weight = scratch.weight;
+    mines.assign(component.num_constraints, 0);
+    free.resize(component.num_constraints);
+    for (int c = 0; c < component.num_constraints; ++c) {
+        free[c] = task_constraints[c].size;
+    }
+    k.assign(num_groups, 0);
+    hi.assign(num_groups, 0);
+    weight.assign(num_groups + 1, 1.0);
+    int total = 0;
+
+    // range of mines a group may contain given the groups assigned so far
+    const auto range = [&](int d, int& low, int& high) {
+        const Group& group = task_groups[d];
+        low = 0;
+        high = group.size;
+        for (int i = 0; i < group.num_constraints; ++i) {
+            const int c = group_constraints[group.first_constraint + i] - component.first_constraint;
+            const int needed = task_constraints[c].value - mines[c];
+            high = std::min(high, needed);
+            low = std::max(low, needed - (free[c] - group.size));
+        }
+    };
+    const auto assign = [&](int d, int n, int sign) {
+        const Group& group = task_groups[d];
+        for (int i = 0; i < group.num_constraints; ++i) {
+            const int c = group_constraints[group.first_constraint + i] - component.first_constraint;
+            mines[c] += sign * n;
+            free[c] -= sign * group.size;
+        }
+        total += sign * n;
+        if (sign > 0) {
+            weight[d + 1] = weight[d] * BINOMIALS[group.size][n];
+        }
+    };
+
+    // fixed groups
+    const int first_depth = task.prefix_size;
+    for (int d = 0; d < first_depth; ++d) {
+        int low, high;
+        range(d, low, high);
+        k[d] = prefixes[task.first_prefix + d];
+        if (k[d] < low || k[d] > high) {
+            return;
+        }
+        assign(d, k[d], 1);
+    }
+
+    // depth-first search, trying each number of mines in the range of each
+    // group, without recursing since components can be large
+    int64_t nodes = 0;
+    int d = first_depth;
+    bool descending = true;
+    while (true) {
+        if (descending) {
+            if (++nodes > MAX_NODES) {
+                task.aborted = true;
+                return;
+            }
+            // NOTE: also checked at the first node, so tasks started after the
+            // interrupt return at once
+            if (nodes % INTERRUPT_CHECK_NODES == 1 && is_interrupted()) {
+                task.interrupted = true;
+                return;
+            }
+            if (d == num_groups) {
+                // record configuration
+                const double w = weight[num_groups];
+                task.counts[total] += w;
+                double* const group_mines = task.group_mines.data() + total * num_groups;
+                for (int g = 0; g < num_groups; ++g) {
+                    if (k[g] > 0) {
+                        group_mines[g] += w * k[g];
+                        task.maybe_mine[g] = true;
+                    }
+                    if (k[g] < task_groups[g].size) {
+                        task.always_mine[g] = false;
+                    }
+                }
+                descending = false;
+                --d;
+                continue;
+            }
+            int lo;
+            range(d, lo, hi[d]);
+            if (lo > hi[d]) {
+                descending = false;
+                --d;
+                continue;
+            }
+            k[d] = lo;
+            assign(d, lo, 1);
+            ++d;
+        } else {
+            if (d < first_depth) {
+                return;
+            }
+            assign(d, k[d], -1);
+            if (k[d] < hi[d]) {
+                ++k[d];
+                assign(d, k[d], 1);
+                ++d;
+                descending = true;
+            } else {
+                --d;
+            }
+        }
+    }
+}
+
+bool Solver::is_interrupted() const
+{
+    return interrupt != nullptr && (interrupt->cancelled.load(std::memory_order_relaxed) ||
+                                    std::chrono::steady_clock::now() >= interrupt->deadline);
+}
+
+void Solver::merge_tasks(Component& component) const
+{
+    component.result.counts.assign(component.num_cells + 1, 0.0);
+    component.result.group_mines.assign((component.num_cells + 1) * component.num_groups, 0.0);
+    component.result.maybe_mine.assign(component.num_groups, false);
+    component.result.always_mine.assign(component.num_groups, true);
+
+    bool found = false;
+    for (int t = component.first_task; t < component.first_task + component.num_tasks; ++t) {
+        const Task& task = tasks[t];
+        if (task.aborted || task.interrupted) {
+            component.result.estimated = true;
+            component.interrupted = task.interrupted;
+            return;
+        }
+        if (std::all_of(task.counts.begin(), task.counts.end(), [](double count) { return count == 0; })) {
+            continue;
+        }
+        found = true;
+        for (size_t i = 0; i < task.counts.size(); ++i) {
+            component.result.counts[i] += task.counts[i];
+        }
+        for (size_t i = 0; i < task.group_mines.size(); ++i) {
+            component.result.group_mines[i] += task.group_mines[i];
+        }
+        for (int g = 0; g < component.num_groups; ++g) {
+            component.result.maybe_mine[g] = component.result.maybe_mine[g] || task.maybe_mine[g];
+            component.result.always_mine[g] = component.result.always_mine[g] && task.always_mine[g];
+        }
+    }
+
+    // no configuration satisfies the constraints, which cannot happen in a
+    // real game
+    if (!found) {
+        component.result.estimated = true;
+    }
+}
+
+void Solver::estimate(const Component& component, Analysis& analysis) const
+{
+    for (int g = component.first_group; g < component.first_group + component.num_groups; ++g) {
+        const Group& group = groups[g];
+        // the densest constraint bounds the probability from below, and
+        // constraints with no mines left or no room left settle the group
+        double probability = 0;
+        bool safe = false;
+        bool mine = false;
+        for (int i = group.first_constraint; i < group.first_constraint + group.num_constraints; ++i) {
+            const Constraint& constraint = constraints[group_constraints[i]];
+            probability = std::max(probability, static_cast<double>(constraint.value) / constraint.size);
+            safe = safe || constraint.value == 0;
+            mine = mine || constraint.value == constraint.size;
+        }
+        if (safe) {
+            probability = 0;
+        } else if (mine) {
+            probability = 1;
+        }
+        for (int i = group.first_cell; i < group.first_cell + group.size; ++i) {
+            const int idx = group_cells[i];
+            analysis.probabilities[idx] = probability;
+            if (safe) {
+                analysis.safe_cells.push_back(idx);
+            } else if (mine) {
+                analysis.mine_cells.push_back(idx);
+            }
+        }
+    }
+}
+
+void Solver::combine(const Game& game, Analysis& analysis)
+{
+    // cells of estimated components are counted with the other cells when
+    // distributing the total number of mines
+    int num_cells = 0;
+    int num_exact = 0;
+    int num_pooled = num_other_cells;
+    for (int c = 0; c < num_components; ++c) {
+        Component& component = components[c];
+        if (component.result.estimated) {
+            num_pooled += component.num_cells;
+            continue;
+        }
+        // keep the counts of large components within range
+        const double max = *std::max_element(component.result.counts.begin(), component.result.counts.end());
+        for (double& count : component.result.counts) {
+            count /= max;
+        }
+        for (double& mines : component.result.group_mines) {
+            mines /= max;
+        }
+        num_cells += component.num_cells;
+        ++num_exact;
+    }
+    const int num_mines = game.mines;
+
+    // weight of each number of mines in a component; the cells of the
+    // component are filled as the weighted average over its configurations
+    const auto fill_component = [&](const Component& component, const std::vector<double>& weights) {
+        double sum = 0;
+        for (int m = 0; m <= component.num_cells; ++m) {
+            sum += component.result.counts[m] * weights[m];
+        }
+        for (int g = 0; g < component.num_groups; ++g) {
+            const Group& group = groups[component.first_group + g];
+            double probability;
+            if (!component.result.maybe_mine[g]) {
+                probability = 0;
+            } else if (component.result.always_mine[g]) {
+                probability = 1;
+            } else {
+                double mines = 0;
+                for (int m = 0; m <= component.num_cells; ++m) {
+                    mines += component.result.group_mines[m * component.num_groups + g] * weights[m];
+                }
+                probability = sum > 0 ? mines / (sum * group.size) : 0;
+            }
+            for (int i = group.first_cell; i < group.first_cell + group.size; ++i) {
+                const int idx = group_cells[i];
+                analysis.probabilities[idx] = probability;
+                if (!component.result.maybe_mine[g]) {
+                    analysis.safe_cells.push_back(idx);
+                } else if (component.result.always_mine[g]) {
+                    analysis.mine_cells.push_back(idx);
+                }
+            }
+        }
+    };
+
+    double other_probability;
+    std::vector<double>& pool_weights = combine_pool;
+    std::vector<std::vector<double>>& suffixes = combine_suffixes;
+    bool exact = num_cells <= MAX_EXACT_CELLS && static_cast<int64_t>(num_exact) * (num_cells + 1) <= MAX_EXACT_WORK;
+    if (exact) {
+        // weight of m mines in all components together is the number of ways
+        // to place the other mines among the pooled cells, C(pooled, total - m)
+        pool_weights.assign(num_cells + 1, 0.0);
+        double max_log = -std::numeric_limits<double>::infinity();
+        for (int m = 0; m <= num_cells; ++m) {
+            const int rest = num_mines - m;
+            if (rest >= 0 && rest <= num_pooled) {
+                pool_weights[m] =
+                    std::lgamma(num_pooled + 1.0) - std::lgamma(rest + 1.0) - std::lgamma(num_pooled - rest + 1.0);
+                max_log = std::max(max_log, pool_weights[m]);
+            } else {
+                pool_weights[m] = -std::numeric_limits<double>::infinity();
+            }
+        }
+        for (double& value : pool_weights) {
+            value = std::exp(value - max_log);
+        }
+        exact = max_log > -std::numeric_limits<double>::infinity();
+    }
+    if (exact) {
+        // suffix[c][x] = sum over mines y in components c.. of
+        //   (ways for components c.. to hold y mines) * pool_weights[x + y]
+        suffixes.resize(num_exact + 1);
+        suffixes[num_exact] = pool_weights;
+        for (int c = num_components - 1, e = num_exact - 1; c >= 0; --c) {
+            const Component& component = components[c];
+            if (component.result.estimated) {
+                continue;
+            }
+            auto& suffix = suffixes[e];
+            suffix.assign(num_cells + 1, 0.0);
+            for (int x = 0; x <= num_cells; ++x) {
+                for (int m = 0; m <= component.num_cells && x + m <= num_cells; ++m) {
+                    suffix[x] += component.result.counts[m] * suffixes[e + 1][x + m];
+                }
+            }
+            normalize(suffix);
+            --e;
+        }
+        // with no way to place all mines, which cannot happen in a real game,
+        // fall back to a density
+        exact = suffixes[0][0] > 0;
+    }
+    if (exact) {
+        // prefix[x] = ways for the components before the current one to hold
+        // x mines
+        std::vector<double>& prefix = combine_prefix;
+        std::vector<double>& next_prefix = combine_next_prefix;
+        std::vector<double>& weights = combine_weights;
+        prefix.assign(1, 1.0);
+        for (int c = 0, e = 0; c < num_components; ++c) {
+            const Component& component = components[c];
+            if (component.result.estimated) {
+                continue;
+            }
+            weights.assign(component.num_cells + 1, 0.0);
+            for (int m = 0; m <= component.num_cells; ++m) {
+                for (size_t x = 0; x < prefix.size(); ++x) {
+                    weights[m] += prefix[x] * at(suffixes[e + 1], x + m);
+                }
+            }
+            fill_component(component, weights);
+
+            next_prefix.assign(prefix.size() + component.num_cells, 0.0);
+            for (size_t x = 0; x < prefix.size(); ++x) {
+                for (int m = 0; m <= component.num_cells; ++m) {
+                    next_prefix[x + m] += prefix[x] * component.result.counts[m];
+                }
+            }
+            normalize(next_prefix);
+            prefix.swap(next_prefix);
+            ++e;
+        }
+
+        // mines left for the pooled cells, over all components
+        double sum = 0;
+        double rest = 0;
+        for (size_t m = 0; m < prefix.size(); ++m) {
+            const double w = prefix[m] * pool_weights[m];
+            sum += w;
+            rest += w * (num_mines - static_cast<int>(m));
+        }
+        other_probability = num_pooled > 0 ? rest / (sum * num_pooled) : 0;
+    } else {
+        // too many cells to account for the total exactly; instead, each mine
+        // is weighted by the odds r = p / (1 - p) of a fixed density p, chosen
+        // so that the expected number of mines matches the total
+        std::vector<double>& component_weights = combine_weights;
+        const auto expected_mines = [&](double log_odds, bool fill) {
+            double expected = num_pooled / (1 + std::exp(-log_odds));
+            for (int c = 0; c < num_components; ++c) {
+                const Component& component = components[c];
+                if (component.result.estimated) {
+                    continue;
+                }
+                // r^m, divided by its largest value over the possible m, which
+                // takes a single call to exp()
+                int low = 0;
+                int high = component.num_cells;
+                while (component.result.counts[low] == 0) {
+                    ++low;
+                }
+                while (component.result.counts[high] == 0) {
+                    --high;
+                }
+                component_weights.assign(component.num_cells + 1, 0.0);
+                const double odds = std::exp(-std::abs(log_odds));
+                if (log_odds >= 0) {
+                    component_weights[high] = 1;
+                    for (int m = high - 1; m >= low; --m) {
+                        component_weights[m] = component_weights[m + 1] * odds;
+                    }
+                } else {
+                    component_weights[low] = 1;
+                    for (int m = low + 1; m <= high; ++m) {
+                        component_weights[m] = component_weights[m - 1] * odds;
+                    }
+                }
+
+                double sum = 0;
+                double mines = 0;
+                for (int m = low; m <= high; ++m) {
+                    const double w = component.result.counts[m] * component_weights[m];
+                    sum += w;
+                    mines += w * m;
+                }
+                expected += mines / sum;
+                if (fill) {
+                    fill_component(component, component_weights);
+                }
+            }
+            return expected;
+        };
+
+        // bisect, since the expected number of mines grows with the odds
+        double lo = -50;
+        double hi = 50;
+        for (int iteration = 0; iteration < 60; ++iteration) {
+            const double mid = (lo + hi) / 2;
+            if (expected_mines(mid, false) < num_mines) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        const double log_odds = (lo + hi) / 2;
+        expected_mines(log_odds, true);
+        other_probability = 1 / (1 + std::exp(-log_odds));
+    }
+
+    // cells not next to any opened cell
+    const auto& cells = game.get_cells();
+    for (int idx = 0; idx < game.rows * game.cols; ++idx) {
+        if (cell_index[idx] == -1 && !(cells[idx] & CELL_OPENED)) {
+            analysis.probabilities[idx] = other_probability;
+            if (other_probability == 0) {
+                analysis.safe_cells.push_back(idx);
+            }
+        }
+    }
+}
+
+}  // namespace ngames::mines
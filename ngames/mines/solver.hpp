@@ -0,0 +1,300 @@
+#pragma once
+
+#include <ngames/mines/game.hpp>
+#include <ngames/mines/transposition_cache.hpp>
+
+#include <ngames/common/work_stealing_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Result of analyzing a position.
+ */
+struct Analysis {
+    // Probability that each cell contains a mine, given what the player sees
+    // and the total number of mines; zero for opened cells.
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::vector<double> probabilities;
+    // Unopened cells certain not to contain a mine, in reading order.
+    std::vector<int> safe_cells;
+    // Unopened cells certain to contain a mine, in reading order.
+    std::vector<int> mine_cells;
+    // Number of frontier components, i.e. groups of unopened cells next to
+    // opened ones that constrain each other.
+    int num_components = 0;
+    // Number of components too large to enumerate, whose probabilities are
+    // estimated from their neighbors instead.
+    int num_estimated = 0;
+    // Whether the analysis was interrupted, in which case the components not
+    // enumerated in time are estimated.
+    bool interrupted = false;
+};
+
+/**
+ * Computes mine probabilities for a position by enumerating the mine
+ * configurations of each frontier component.
+ *
+ * Components do not constrain each other, other than through the total number
+ * of mines, so each is enumerated as an independent task on a work-stealing
+ * thread pool; large components are further split by fixing their first
+ * cells, so one hard component does not hold up the whole position. Task
+ * results are merged in a fixed order, so the analysis does not depend on the
+ * number of threads.
+ *
+ * The enumeration of a component only depends on its shape, i.e. the
+ * positions of its cells relative to each other and the counts of its opened
+ * cells, so components are keyed by a Zobrist hash of their shape and their
+ * enumerations can be kept in a cache shared by several solvers, e.g. to
+ * reuse the components a move did not touch, or common shapes across games.
+ *
+ * Flags are not trusted, i.e. flagged cells are treated as unopened.
+ */
+class Solver
+{
+public:
+    /**
+     * Enumeration of a component.
+     */
+    struct Result {
+        // Whether the component is estimated instead of enumerated.
+        bool estimated = false;
+        // Number of configurations with m mines, for each m, scaled by an
+        // arbitrary factor.
+        std::vector<double> counts;
+        // Expected number of mines in each group, summed over the
+        // configurations with m mines: index m * num_groups + group.
+        std::vector<double> group_mines;
+        // Whether each group contains a mine in some/all configurations.
+        std::vector<bool> maybe_mine;
+        std::vector<bool> always_mine;
+    };
+
+    using Cache = TranspositionCache<Result>;
+
+    /**
+     * Condition to cut an analysis short, so that it returns its best answer
+     * so far.
+     */
+    struct Interrupt {
+        // Time after which the analysis stops enumerating.
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        // Set from any thread to stop enumerating as soon as possible.
+        std::atomic<bool> cancelled = false;
+    };
+
+    // Components with more groups than this are estimated instead of
+    // enumerated. Cells next to the same opened cells form a single group.
+    static constexpr int MAX_GROUPS = 160;
+    // Most search nodes per task, before giving up and estimating the
+    // component instead.
+    static constexpr int64_t MAX_NODES = int64_t(1) << 22;
+    // Search nodes between checks for an interrupt.
+    static constexpr int64_t INTERRUPT_CHECK_NODES = 1024;
+    // Components with at least this many groups are split into several tasks.
+    static constexpr int SPLIT_GROUPS = 24;
+    // Number of leading groups fixed by each task of a split component.
+    static constexpr int SPLIT_DEPTH = 3;
+    // The total number of mines is accounted for exactly if components have
+    // at most this many cells in total, and the number of components times
+    // that is at most `MAX_EXACT_WORK`. Otherwise it is approximated by a
+    // density, which is accurate on large boards.
+    static constexpr int MAX_EXACT_CELLS = 4096;
+    static constexpr int64_t MAX_EXACT_WORK = int64_t(1) << 21;
+
+    /**
+     * Create solver.
+     * @param num_threads Number of threads enumerating components, including
+     * the calling thread.
+     * @param cache Cache of component enumerations, if any. Must outlive the
+     * solver, and may be shared with other solvers.
+     */
+    Solver(int num_threads = 1, Cache* cache = nullptr);
+
+    /**
+     * Analyze a position. Reuses the memory of previous analyses.
+     * @param game Game, which should be active.
+     * @param analysis Set to the analysis.
+     * @param interrupt If not null, components still being enumerated once
+     * this fires are estimated instead. Finding and combining components is
+     * not interrupted, and takes time linear in the number of cells.
+     */
+    void analyze(const Game& game, Analysis& analysis, const Interrupt* interrupt = nullptr);
+
+private:
+    /**
+     * Cells next to the same opened cells, which are interchangeable when
+     * counting configurations.
+     */
+    struct Group {
+        // Number of cells.
+        int size;
+        // Cells, in `group_cells`.
+        int first_cell;
+        // Constraints on the group, in `group_constraints`.
+        int first_constraint;
+        int num_constraints;
+    };
+
+    /**
+     * Opened cell next to unopened cells, whose count must be matched.
+     */
+    struct Constraint {
+        // Number of mines among the unopened neighbors.
+        int value;
+        // Number of unopened neighbors.
+        int size;
+    };
+
+    /**
+     * Set of groups constraining each other, and the search results once
+     * merged from its tasks.
+     */
+    struct Component {
+        // Groups, in `groups`, in search order.
+        int first_group;
+        int num_groups;
+        // Constraints, in `constraints`.
+        int first_constraint;
+        int num_constraints;
+        // Number of cells.
+        int num_cells;
+        // Tasks, in `tasks`.
+        int first_task;
+        int num_tasks;
+        // Zobrist hash of the shape of the component.
+        HashKey key;
+        // Whether the result was found in the cache.
+        bool cached;
+        // Whether a task was interrupted, so the result must not be cached.
+        bool interrupted;
+        Result result;
+    };
+
+    /**
+     * Search of a component, possibly with its first groups fixed.
+     */
+    struct Task {
+        int component;
+        // Mines of the fixed groups, in `prefixes`.
+        int first_prefix;
+        int prefix_size;
+        // Results, in the same layout as those of `Component`.
+        std::vector<double> counts;
+        std::vector<double> group_mines;
+        std::vector<bool> maybe_mine;
+        std::vector<bool> always_mine;
+        // Whether the node limit was reached.
+        bool aborted;
+        // Whether the analysis was interrupted.
+        bool interrupted;
+    };
+
+    /**
+     * Memory used by a thread while searching.
+     */
+    struct Scratch {
+        // Mines so far and unassigned cells, for each constraint.
+        std::vector<int> mines;
+        std::vector<int> free;
+        // Mines, and range of mines left to try, for each depth.
+        std::vector<int> k;
+        std::vector<int> hi;
+        // Number of configurations of the groups before each depth.
+        std::vector<double> weight;
+    };
+
+    /**
+     * Split the unopened cells next to opened ones into components and groups.
+     * @param game Game.
+     */
+    void find_components(const Game& game);
+
+    /**
+     * Create the tasks of a component.
+     * @param component Component index.
+     */
+    void plan_tasks(int component);
+
+    /**
+     * Enumerate the configurations of a task.
+     * @param task Task.
+     * @param scratch Memory of the thread.
+     */
+    void search(Task& task, Scratch& scratch) const;
+
+    /**
+     * Return whether the interrupt of the current analysis fired.
+     */
+    bool is_interrupted() const;
+
+    /**
+     * Sum the results of the tasks of a component, in task order.
+     * @param component Component.
+     */
+    void merge_tasks(Component& component) const;
+
+    /**
+     * Estimate the probabilities of a component too large to enumerate from
+     * its constraints alone.
+     * @param component Component.
+     * @param analysis Analysis to fill.
+     */
+    void estimate(const Component& component, Analysis& analysis) const;
+
+    /**
+     * Combine the components with the total number of mines, and fill the
+     * probabilities of their cells and of the cells not next to opened ones.
+     * @param game Game.
+     * @param analysis Analysis to fill.
+     */
+    void combine(const Game& game, Analysis& analysis);
+
+    WorkStealingPool pool;
+    Cache* const cache;
+    std::vector<Scratch> scratches;
+    // Interrupt of the current analysis, if any.
+    const Interrupt* interrupt;
+
+    // Position being analyzed. Components and tasks past the number in use
+    // are kept to reuse their memory.
+    std::vector<Component> components;
+    int num_components;
+    std::vector<Group> groups;
+    std::vector<Constraint> constraints;
+    std::vector<Task> tasks;
+    int num_tasks;
+    // Tasks, largest component first.
+    std::vector<int> task_order;
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::vector<int> group_cells;
+    // Constraints of each group, as indices into `constraints`.
+    std::vector<int> group_constraints;
+    std::vector<int> prefixes;
+
+    // Per cell: group of an unopened cell, or constraint of an opened one, or
+    // -1 if unvisited. Reused between analyses.
+    std::vector<int> cell_index;
+    // Unopened cells not next to any opened cell.
+    int num_other_cells;
+
+    // Scratch memory of `find_components()` and `combine()`.
+    std::vector<int> component_order;
+    std::vector<std::pair<std::array<int, 8>, int>> component_keys;
+    std::vector<int> component_group_starts;
+    std::vector<double> combine_pool;
+    std::vector<std::vector<double>> combine_suffixes;
+    std::vector<double> combine_prefix;
+    std::vector<double> combine_next_prefix;
+    std::vector<double> combine_weights;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,111 @@
+#include <ngames/mines/summary.hpp>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+Summary::Summary(int rows, int cols, std::pmr::memory_resource* memory) : rows(rows), cols(cols), levels(memory)
+{
+    assert(rows > 0);
+    assert(cols > 0);
+
+    // create levels until a single tile covers the board
+    for (int level = 0;; ++level) {
+        const int size = tile_size(level);
+        const int level_rows = (rows + size - 1) / size;
+        const int level_cols = (cols + size - 1) / size;
+
+        std::pmr::vector<Counts> tiles(level_rows * level_cols, memory);
+        for (int tile_row = 0; tile_row < level_rows; ++tile_row) {
+            for (int tile_col = 0; tile_col < level_cols; ++tile_col) {
+                // tiles on the bottom and right edges may be cut off by the board
+                const int tile_rows = std::min(size, rows - tile_row * size);
+                const int tile_cols = std::min(size, cols - tile_col * size);
+                tiles[tile_row * level_cols + tile_col].cells = tile_rows * tile_cols;
+            }
+        }
+        levels.push_back({.rows = level_rows, .cols = level_cols, .tiles = std::move(tiles)});
+
+        if (level_rows == 1 && level_cols == 1) {
+            break;
+        }
+    }
+}
+
+void Summary::reset()
+{
+    for (auto& level : levels) {
+        for (auto& tile : level.tiles) {
+            tile.opened = 0;
+            tile.flagged = 0;
+        }
+    }
+}
+
+void Summary::update(int row, int col, int d_opened, int d_flagged)
+{
+    assert(0 <= row && row < rows);  // row must be valid
+    assert(0 <= col && col < cols);  // col must be valid
+
+    for (int level = 0; level < num_levels(); ++level) {
+        auto& tile = levels[level].tiles[(row >> level) / TILE_SIZE * levels[level].cols + (col >> level) / TILE_SIZE];
+        tile.opened += d_opened;
+        tile.flagged += d_flagged;
+    }
+}
+
+int Summary::level_for(int region_rows, int region_cols) const
+{
+    // NOTE: the longer side, so that a thin region still spans a few tiles;
+    // along the shorter side it falls within a single tile, see `query()`
+    const int region_size = std::max(region_rows, region_cols);
+    int level = 0;
+    while (level + 1 < num_levels() && tile_size(level + 1) <= region_size) {
+        ++level;
+    }
+    return level;
+}
+
+Summary::Counts Summary::query(int row_begin, int col_begin, int row_end, int col_end, int level) const
+{
+    assert(0 <= level && level < num_levels());  // level must be valid
+
+    const Level& tiles = levels[level];
+    const int size = tile_size(level);
+
+    // tiles whose top-left cell lies inside the region, clipped to the board
+    row_begin = std::max(row_begin, 0);
+    col_begin = std::max(col_begin, 0);
+    row_end = std::min(row_end, rows);
+    col_end = std::min(col_end, cols);
+    int tile_row_begin = (row_begin + size - 1) / size;
+    int tile_col_begin = (col_begin + size - 1) / size;
+    int tile_row_end = (row_end + size - 1) / size;
+    int tile_col_end = (col_end + size - 1) / size;
+    // a region thinner than the tiles takes the tile it starts in
+    if (tile_row_begin >= tile_row_end && row_begin < row_end) {
+        tile_row_begin = row_begin / size;
+        tile_row_end = tile_row_begin + 1;
+    }
+    if (tile_col_begin >= tile_col_end && col_begin < col_end) {
+        tile_col_begin = col_begin / size;
+        tile_col_end = tile_col_begin + 1;
+    }
+
+    Counts counts;
+    for (int tile_row = tile_row_begin; tile_row < tile_row_end; ++tile_row) {
+        for (int tile_col = tile_col_begin; tile_col < tile_col_end; ++tile_col) {
+            const Counts& tile = tiles.tiles[tile_row * tiles.cols + tile_col];
+            counts.cells += tile.cells;
+            counts.opened += tile.opened;
+            counts.flagged += tile.flagged;
+        }
+    }
+    return counts;
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Multi-level summary of the cells opened and flagged by the player, used to
+ * answer region queries without visiting individual cells.
+ *
+ * Level 0 divides the board into square tiles of `TILE_SIZE` cells. Each
+ * subsequent level merges 2x2 tiles of the level below, until a single tile
+ * covers the whole board. Updating a cell touches one tile per level.
+ */
+class Summary
+{
+public:
+    // Side length of a level 0 tile, in number of cells.
+    static constexpr int TILE_SIZE = 8;
+
+    /**
+     * Aggregated counts for a group of cells.
+     */
+    struct Counts {
+        // Number of cells.
+        int cells = 0;
+        // Number of opened cells.
+        int opened = 0;
+        // Number of flagged cells.
+        int flagged = 0;
+    };
+
+    /**
+     * Create summary for an empty board.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param memory Memory resource for the allocations of the summary, e.g. an arena.
+     */
+    Summary(int rows, int cols, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    /**
+     * Reset all counts to zero.
+     */
+    void reset();
+
+    /**
+     * Update the counts for the tiles containing a cell.
+     * @param row Cell row.
+     * @param col Cell column.
+     * @param d_opened Change in the number of opened cells.
+     * @param d_flagged Change in the number of flagged cells.
+     */
+    void update(int row, int col, int d_opened, int d_flagged);
+
+    /**
+     * Return the coarsest level whose tiles are no larger than the longer side
+     * of the given region, so that a query over the region visits at most a
+     * few tiles, however thin the region.
+     * @param region_rows Number of rows in the region.
+     * @param region_cols Number of columns in the region.
+     */
+    int level_for(int region_rows, int region_cols) const;
+
+    /**
+     * Aggregate the counts of all tiles at a level whose top-left cell lies
+     * inside the region [row_begin, row_end) x [col_begin, col_end). Region
+     * boundaries are therefore snapped to the tile grid of that level. Along
+     * a side where the region holds no such cell, i.e. where it is thinner
+     * than the tiles, the tile it starts in is used instead, so a non-empty
+     * region is never empty of tiles. Takes time proportional to the number
+     * of tiles visited.
+     * @param row_begin First row of the region.
+     * @param col_begin First column of the region.
+     * @param row_end One past the last row of the region.
+     * @param col_end One past the last column of the region.
+     * @param level Level of the tiles to aggregate.
+     */
+    Counts query(int row_begin, int col_begin, int row_end, int col_end, int level) const;
+
+    /**
+     * Return number of levels.
+     */
+    inline int num_levels() const { return static_cast<int>(levels.size()); }
+
+    /**
+     * Return side length of the tiles at a level, in number of cells.
+     * @param level Level.
+     */
+    inline int tile_size(int level) const { return TILE_SIZE << level; }
+
+    const int rows;
+    const int cols;
+
+private:
+    /**
+     * Tiles of a single level.
+     */
+    struct Level {
+        // Number of rows of tiles.
+        int rows;
+        // Number of columns of tiles.
+        int cols;
+        // Counts for each tile.
+        // NOTE: we encode the pair (tile_row, tile_col) as a single integer: tile_row * cols + tile_col
+        std::pmr::vector<Counts> tiles;
+    };
+
+    std::pmr::vector<Level> levels;
+};
+
+}  // namespace ngames::mines
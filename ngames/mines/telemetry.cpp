@@ -0,0 +1,129 @@
+#include <ngames/mines/telemetry.hpp>
+
+
+namespace
+{
+
+inline uint64_t ns_between(ngames::mines::Telemetry::Clock::time_point start,
+                           ngames::mines::Telemetry::Clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+}  // namespace
+
+
+namespace ngames::mines
+{
+
+Telemetry::Telemetry()
+    : num_keys(0),
+      num_mouse_events(0),
+      num_batches(0),
+      num_renders(0),
+      in_input(false),
+      rendered(false),
+      idle(false)
+{
+}
+
+void Telemetry::input_start(bool mouse)
+{
+    ++(mouse ? num_mouse_events : num_keys);
+    if (in_input) {
+        return;
+    }
+    input_time = Clock::now();
+    if (idle) {
+        think.record(ns_between(idle_time, input_time));
+    }
+    ++num_batches;
+    in_input = true;
+    rendered = false;
+}
+
+void Telemetry::input_end()
+{
+    if (!in_input) {
+        return;
+    }
+    idle_time = Clock::now();
+    idle = true;
+    if (!rendered) {
+        update.record(ns_between(input_time, idle_time));
+    }
+    in_input = false;
+}
+
+void Telemetry::render_start()
+{
+    render_time = Clock::now();
+    // NOTE: only the first refresh of a batch counts as its update; later
+    // ones, and refreshes outside of batches, only count as rendering
+    if (in_input && !rendered) {
+        update.record(ns_between(input_time, render_time));
+    }
+}
+
+void Telemetry::output_start()
+{
+    output_time = Clock::now();
+}
+
+void Telemetry::render_end()
+{
+    const Clock::time_point end = Clock::now();
+    compose.record(ns_between(render_time, output_time));
+    output.record(ns_between(output_time, end));
+    if (in_input && !rendered) {
+        latency.record(ns_between(input_time, end));
+        rendered = true;
+        ++num_renders;
+    }
+}
+
+void Telemetry::write(FILE* file) const
+{
+    fprintf(file, "keys          %llu\n", static_cast<unsigned long long>(num_keys));
+    fprintf(file, "mouse events  %llu\n", static_cast<unsigned long long>(num_mouse_events));
+    fprintf(file, "batches       %llu\n", static_cast<unsigned long long>(num_batches));
+    fprintf(file, "redraws       %llu\n", static_cast<unsigned long long>(num_renders));
+
+    // print think time in milliseconds, and the rest in microseconds
+    struct Entry {
+        const char* name;
+        const Histogram& histogram;
+        double scale;
+        const char* unit;
+    };
+    const Entry entries[] = {
+        {"think", think, 1e6, "ms"},
+        {"update", update, 1e3, "us"},
+        {"compose", compose, 1e3, "us"},
+        {"output", output, 1e3, "us"},
+        {"latency", latency, 1e3, "us"},
+    };
+    for (const Entry& entry : entries) {
+        const Histogram& histogram = entry.histogram;
+        fprintf(file,
+                "%-9s count %llu  p50 %.1f%s  p90 %.1f%s  p99 %.1f%s  max %.1f%s  mean %.1f%s\n",
+                entry.name,
+                static_cast<unsigned long long>(histogram.get_count()),
+                histogram.percentile(50) / entry.scale,
+                entry.unit,
+                histogram.percentile(90) / entry.scale,
+                entry.unit,
+                histogram.percentile(99) / entry.scale,
+                entry.unit,
+                histogram.get_max() / entry.scale,
+                entry.unit,
+                histogram.get_mean() / entry.scale,
+                entry.unit);
+    }
+    for (const Entry& entry : entries) {
+        fprintf(file, "\n%s histogram (%s):\n", entry.name, entry.unit);
+        entry.histogram.print(file, entry.scale);
+    }
+}
+
+}  // namespace ngames::mines
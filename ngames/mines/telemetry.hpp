@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ngames/common/histogram.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Timings of an interactive session: how long the player thinks between
+ * moves, and how long each move takes to reach the screen, split into the
+ * engine update, the ncurses work and the terminal output, so slow frames can
+ * be attributed.
+ *
+ * The application reports the stages of each batch of input events as they
+ * happen: input events that arrive together are handled together and shown
+ * with a single screen update, so they are timed from the first event of the
+ * batch. Each stage reads the clock once and records into a histogram, so
+ * telemetry never allocates while playing.
+ */
+class Telemetry
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Telemetry();
+
+    /**
+     * Report that an input event arrived, starting a batch unless one is
+     * being handled.
+     * @param mouse Whether the event is a mouse event, rather than a key.
+     */
+    void input_start(bool mouse);
+
+    /**
+     * Report that a batch of input events was handled, whether or not it
+     * redrew the screen.
+     */
+    void input_end();
+
+    /**
+     * Report that the application started refreshing its windows.
+     */
+    void render_start();
+
+    /**
+     * Report that the windows were refreshed, and the screen is about to be
+     * updated.
+     */
+    void output_start();
+
+    /**
+     * Report that the screen was updated.
+     */
+    void render_end();
+
+    /**
+     * Write a summary and the histograms of all timings.
+     * @param file File to write to.
+     */
+    void write(FILE* file) const;
+
+private:
+    // Time from the end of a batch to the next input event.
+    Histogram think;
+    // Time from the first input event of a batch to the start of its
+    // refresh, or to its end if it did not redraw the screen: moving the
+    // cursor, or updating the game.
+    Histogram update;
+    // Time spent by ncurses refreshing windows.
+    Histogram compose;
+    // Time spent by ncurses writing to the terminal.
+    Histogram output;
+    // Time from the first input event of a batch to the end of its screen
+    // update.
+    Histogram latency;
+
+    uint64_t num_keys;
+    uint64_t num_mouse_events;
+    uint64_t num_batches;
+    // Number of batches that redrew the screen.
+    uint64_t num_renders;
+
+    // Whether a batch is being handled, and whether it redrew the screen.
+    bool in_input;
+    bool rendered;
+    // Whether the player has seen the result of a batch, i.e. whether
+    // `idle_time` is set.
+    bool idle;
+    Clock::time_point input_time;
+    Clock::time_point render_time;
+    Clock::time_point output_time;
+    Clock::time_point idle_time;
+};
+
+}  // namespace ngames::mines
@@ -17,11 +17,13 @@ void TextInstructions::refresh() const
     constexpr auto attr = COLOR_PAIR(COLOR_PAIR_INSTRUCTIONS);
     wattron(window, attr);
     mvwprintw(window, 0, 0, "move cursor     hjkl / arrow keys");
-    mvwprintw(window, 1, 0, "toggle flag     f / right click");
-    mvwprintw(window, 2, 0, "open / chord    space / left click");
-    mvwprintw(window, 3, 0, "refresh ui      r");
-    mvwprintw(window, 4, 0, "new game        z");
-    mvwprintw(window, 5, 0, "quit            q");
+    mvwprintw(window, 1, 0, "jump unresolved n / p");
+    mvwprintw(window, 2, 0, "toggle flag     f / right click");
+    mvwprintw(window, 3, 0, "open / chord    space / left click");
+    mvwprintw(window, 4, 0, "hint            ?");
+    mvwprintw(window, 5, 0, "refresh ui      r");
+    mvwprintw(window, 6, 0, "new game        z");
+    mvwprintw(window, 7, 0, "quit            q");
     wattroff(window, attr);
     wnoutrefresh(window);
 }
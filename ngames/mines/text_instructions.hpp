@@ -12,7 +12,7 @@ namespace ngames::mines
 class TextInstructions : public Component
 {
 public:
-    static constexpr int HEIGHT = 6;
+    static constexpr int HEIGHT = 8;
     static constexpr int WIDTH = 80;
 
     /**
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Key of a position, or part of one, made of two independent 64-bit hashes,
+ * so that distinct positions practically never share a key.
+ */
+struct HashKey {
+    uint64_t hash;
+    uint64_t check;
+
+    inline bool operator==(const HashKey& other) const = default;
+};
+
+/**
+ * Counters of a `TranspositionCache`.
+ */
+struct CacheStats {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    uint64_t inserts = 0;
+    uint64_t evictions = 0;
+
+    inline double hit_rate() const { return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0; }
+};
+
+/**
+ * Bounded, thread-safe map from hash keys to immutable values, evicting the
+ * least recently used entry when full. Split into shards with their own lock,
+ * so threads rarely wait for each other. Values are shared, so they stay
+ * valid after eviction for as long as a caller holds them.
+ */
+template <typename Value>
+class TranspositionCache
+{
+public:
+    static constexpr int NUM_SHARDS = 64;
+
+    /**
+     * Create empty cache.
+     * @param capacity Most entries held.
+     */
+    TranspositionCache(size_t capacity) : shard_capacity(std::max<size_t>(1, capacity / NUM_SHARDS)), shards(NUM_SHARDS)
+    {
+    }
+
+    /**
+     * Look up a value, marking it as recently used.
+     * @param key Key.
+     * @returns Value, or null if not cached.
+     */
+    std::shared_ptr<const Value> find(const HashKey& key)
+    {
+        lookups.fetch_add(1, std::memory_order_relaxed);
+        Shard& shard = shard_of(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return nullptr;
+        }
+        hits.fetch_add(1, std::memory_order_relaxed);
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * Add a value, evicting the least recently used entry of its shard if
+     * full. Replaces any value with the same key.
+     * @param key Key.
+     * @param value Value.
+     */
+    void insert(const HashKey& key, std::shared_ptr<const Value> value)
+    {
+        inserts.fetch_add(1, std::memory_order_relaxed);
+        Shard& shard = shard_of(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        if (shard.entries.size() >= shard_capacity) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    /**
+     * Return the counters since creation.
+     */
+    CacheStats get_stats() const
+    {
+        return {
+            .lookups = lookups.load(std::memory_order_relaxed),
+            .hits = hits.load(std::memory_order_relaxed),
+            .inserts = inserts.load(std::memory_order_relaxed),
+            .evictions = evictions.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    struct KeyHash {
+        inline size_t operator()(const HashKey& key) const { return key.hash; }
+    };
+
+    using Entries = std::list<std::pair<HashKey, std::shared_ptr<const Value>>>;
+
+    /**
+     * Part of the cache guarded by its own lock.
+     */
+    struct Shard {
+        std::mutex mutex;
+        // Most recently used first.
+        Entries entries;
+        std::unordered_map<HashKey, typename Entries::iterator, KeyHash> index;
+    };
+
+    inline Shard& shard_of(const HashKey& key)
+    {
+        // NOTE: the low bits pick the bucket within a shard, so pick the shard
+        // with the high bits
+        static_assert(NUM_SHARDS == 64);
+        return shards[key.hash >> 58];
+    }
+
+    const size_t shard_capacity;
+    std::vector<Shard> shards;
+
+    std::atomic<uint64_t> lookups = 0;
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<uint64_t> inserts = 0;
+    std::atomic<uint64_t> evictions = 0;
+};
+
+}  // namespace ngames::mines
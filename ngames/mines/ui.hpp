@@ -11,6 +11,10 @@ constexpr short COLOR_GREY = 8;  // new color id
 
 // Color pair for mistakes
 constexpr short COLOR_PAIR_MISTAKE = 9;  // new color pair id
+// Color pair for a hinted cell certain to be safe
+constexpr short COLOR_PAIR_HINT_SAFE = 10;  // new color pair id
+// Color pair for a hinted cell that may contain a mine
+constexpr short COLOR_PAIR_HINT_GUESS = 11;  // new color pair id
 // Color pair for unopened cell
 constexpr short COLOR_PAIR_UNOPENED = 8;  // use same color as cell 8, i.e. grey text
 // Color pair for winning text
@@ -42,6 +46,10 @@ inline void init_colors()
 
     // define color pair for mistakes
     init_pair(COLOR_PAIR_MISTAKE, COLOR_WHITE, COLOR_RED);
+
+    // define color pairs for hints
+    init_pair(COLOR_PAIR_HINT_SAFE, COLOR_BLACK, COLOR_GREEN);
+    init_pair(COLOR_PAIR_HINT_GUESS, COLOR_BLACK, COLOR_YELLOW);
 };
 
 }  // namespace ngames::mines
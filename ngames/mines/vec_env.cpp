@@ -0,0 +1,167 @@
+#include <ngames/mines/vec_env.hpp>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+namespace ngames::mines
+{
+
+VecEnv::VecEnv(int num_envs, int rows, int cols, int mines, uint64_t seed, int num_threads)
+    : num_envs(num_envs),
+      rows(rows),
+      cols(cols),
+      mines(mines),
+      num_threads(num_threads),
+      numbers(static_cast<size_t>(num_envs) * rows * cols),
+      opened(static_cast<size_t>(num_envs) * rows * cols),
+      flagged(static_cast<size_t>(num_envs) * rows * cols),
+      rewards(num_envs),
+      dones(num_envs),
+      pending_actions(nullptr),
+      stopping(false),
+      start_barrier(num_threads),
+      end_barrier(num_threads)
+{
+    assert(num_envs > 0);
+    assert(num_threads > 0);
+
+    games.reserve(num_envs);
+    rngs.reserve(num_envs);
+    for (int env = 0; env < num_envs; ++env) {
+        // each environment gets its own RNG so that its games do not depend
+        // on which thread steps it
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(env)};
+        rngs.emplace_back(seq);
+        games.emplace_back(rows, cols, mines, static_cast<unsigned>(rngs[env]()));
+        games.back().track_changes(true);
+        clear_observations(env);
+    }
+
+    workers.reserve(num_threads - 1);
+    for (int thread = 1; thread < num_threads; ++thread) {
+        workers.emplace_back(&VecEnv::work, this, thread);
+    }
+}
+
+VecEnv::~VecEnv()
+{
+    if (!workers.empty()) {
+        stopping = true;
+        start_barrier.arrive_and_wait();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void VecEnv::reset()
+{
+    pending_actions = nullptr;
+    run_all();
+}
+
+void VecEnv::step(const Action* actions)
+{
+    pending_actions = actions;
+    run_all();
+}
+
+void VecEnv::run_all()
+{
+    if (workers.empty()) {
+        run(0, num_envs);
+        return;
+    }
+    start_barrier.arrive_and_wait();
+    run(0, num_envs / num_threads);
+    end_barrier.arrive_and_wait();
+}
+
+void VecEnv::work(int thread)
+{
+    // split the environments evenly between the threads
+    const int env_begin = static_cast<int64_t>(num_envs) * thread / num_threads;
+    const int env_end = static_cast<int64_t>(num_envs) * (thread + 1) / num_threads;
+
+    while (true) {
+        start_barrier.arrive_and_wait();
+        if (stopping) {
+            return;
+        }
+        run(env_begin, env_end);
+        end_barrier.arrive_and_wait();
+    }
+}
+
+void VecEnv::run(int env_begin, int env_end)
+{
+    for (int env = env_begin; env < env_end; ++env) {
+        if (pending_actions != nullptr) {
+            step_env(env, pending_actions[env]);
+        } else {
+            rewards[env] = 0.0f;
+            dones[env] = 0;
+            reset_env(env);
+        }
+    }
+}
+
+void VecEnv::reset_env(int env)
+{
+    Game& game = games[env];
+    game.reset(static_cast<unsigned>(rngs[env]()));
+    game.clear_changes();
+    clear_observations(env);
+}
+
+void VecEnv::clear_observations(int env)
+{
+    const size_t offset = static_cast<size_t>(env) * rows * cols;
+    std::fill_n(numbers.begin() + offset, rows * cols, Game::UNSET_NEIGHBOR_MINE_COUNT);
+    std::fill_n(opened.begin() + offset, rows * cols, 0);
+    std::fill_n(flagged.begin() + offset, rows * cols, 0);
+}
+
+void VecEnv::step_env(int env, const Action& action)
+{
+    assert(0 <= action.cell && action.cell < rows * cols);  // cell must be valid
+
+    Game& game = games[env];
+    const int row = action.cell / cols;
+    const int col = action.cell % cols;
+    const int prev_num_opened = game.get_num_opened();
+
+    const int code = action.type == ActionType::flag ? game.toggle_flag(row, col) : game.click_cell(row, col);
+    if (code != 0) {
+        rewards[env] = INVALID_REWARD;
+    } else if (game.get_state() == Game::State::lose) {
+        rewards[env] = LOSE_REWARD;
+    } else {
+        rewards[env] = static_cast<float>(game.get_num_opened() - prev_num_opened) / (rows * cols - mines);
+    }
+
+    if (game.get_state() != Game::State::active) {
+        dones[env] = 1;
+        reset_env(env);
+    } else {
+        dones[env] = 0;
+        write_changes(env);
+    }
+}
+
+void VecEnv::write_changes(int env)
+{
+    Game& game = games[env];
+    const size_t offset = static_cast<size_t>(env) * rows * cols;
+    for (const int idx : game.get_changes()) {
+        const Cell cell = game.get_cells()[idx];
+        numbers[offset + idx] = cell & CELL_OPENED ? cell & CELL_COUNT_MASK : Game::UNSET_NEIGHBOR_MINE_COUNT;
+        opened[offset + idx] = (cell & CELL_OPENED) != 0;
+        flagged[offset + idx] = (cell & CELL_FLAGGED) != 0;
+    }
+    game.clear_changes();
+}
+
+}  // namespace ngames::mines
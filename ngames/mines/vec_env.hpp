@@ -0,0 +1,191 @@
+#pragma once
+
+#include <ngames/mines/game.hpp>
+
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Batch of Minesweeper games stepped in lock-step, e.g. for reinforcement
+ * learning. Observations are written into preallocated structure-of-arrays
+ * buffers with shape (num_envs, rows * cols), where cell (row, col) of
+ * environment `env` is at index env * rows * cols + row * cols + col.
+ *
+ * Games that end are immediately reset with a seed drawn from the RNG of the
+ * environment, so the observation after a step that ends a game is the first
+ * observation of the next game. Given the same seed, the same actions produce
+ * the same observations regardless of the number of threads.
+ *
+ * After construction, stepping and resetting do not allocate.
+ */
+class VecEnv
+{
+public:
+    enum ActionType : uint8_t { click = 0, flag = 1 };
+
+    /**
+     * Action for a single environment.
+     */
+    struct Action {
+        // Cell to act on.
+        // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+        int32_t cell;
+        // Whether to click the cell or toggle its flag.
+        uint8_t type;
+    };
+
+    // Reward for losing a game.
+    static constexpr float LOSE_REWARD = -1.0f;
+    // Reward for an action that does not change the game, e.g. clicking an
+    // opened cell that cannot be chorded.
+    static constexpr float INVALID_REWARD = -0.01f;
+
+    /**
+     * Create environments and reset them.
+     * @param num_envs Number of environments.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param mines Number of mines.
+     * @param seed Seed for the RNGs placing the mines of each environment.
+     * @param num_threads Number of threads stepping the environments,
+     * including the calling thread.
+     */
+    VecEnv(int num_envs, int rows, int cols, int mines, uint64_t seed, int num_threads = 1);
+
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    /**
+     * Reset all environments with new seeds.
+     */
+    void reset();
+
+    /**
+     * Apply one action to each environment and update the observations,
+     * rewards and done flags.
+     *
+     * Opening a safe cell is rewarded with the fraction of safe cells it
+     * opened, so that winning a game sums up to a reward of 1. Opening a mine
+     * is rewarded with `LOSE_REWARD`, and an action that does not change the
+     * game with `INVALID_REWARD`.
+     *
+     * @param actions Array of `num_envs` actions.
+     */
+    void step(const Action* actions);
+
+    /**
+     * Return number of neighboring mines of each cell, or -1 for unopened cells.
+     */
+    inline const int8_t* get_numbers() const { return numbers.data(); }
+
+    /**
+     * Return 1 for opened cells, 0 otherwise.
+     */
+    inline const uint8_t* get_opened() const { return opened.data(); }
+
+    /**
+     * Return 1 for flagged cells, 0 otherwise.
+     */
+    inline const uint8_t* get_flagged() const { return flagged.data(); }
+
+    /**
+     * Return reward of each environment for the last step.
+     */
+    inline const float* get_rewards() const { return rewards.data(); }
+
+    /**
+     * Return 1 for each environment whose game ended in the last step, 0
+     * otherwise.
+     */
+    inline const uint8_t* get_dones() const { return dones.data(); }
+
+    /**
+     * Return game of an environment.
+     * @param env Environment index.
+     */
+    inline const Game& get_game(int env) const { return games[env]; }
+
+    const int num_envs;
+    const int rows;
+    const int cols;
+    const int mines;
+    const int num_threads;
+
+private:
+    /**
+     * Reset or step the environments [env_begin, env_end).
+     * @param env_begin First environment.
+     * @param env_end One past the last environment.
+     */
+    void run(int env_begin, int env_end);
+
+    /**
+     * Reset an environment with a new seed and clear its observations.
+     * @param env Environment index.
+     */
+    void reset_env(int env);
+
+    /**
+     * Clear the observations of an environment, as for a new game.
+     * @param env Environment index.
+     */
+    void clear_observations(int env);
+
+    /**
+     * Apply an action to an environment, see `step()`.
+     * @param env Environment index.
+     * @param action Action.
+     */
+    void step_env(int env, const Action& action);
+
+    /**
+     * Write the observations of the cells changed in a game since the last
+     * call.
+     * @param env Environment index.
+     */
+    void write_changes(int env);
+
+    /**
+     * Dispatch `run()` over all threads and wait for them to finish.
+     */
+    void run_all();
+
+    /**
+     * Main loop of a worker thread.
+     * @param thread Thread index, starting at 1 since the calling thread is 0.
+     */
+    void work(int thread);
+
+    // Games, one per environment.
+    std::vector<Game> games;
+    // RNGs drawing the seeds of each environment.
+    std::vector<std::mt19937_64> rngs;
+
+    // Observation buffers, see the getters.
+    std::vector<int8_t> numbers;
+    std::vector<uint8_t> opened;
+    std::vector<uint8_t> flagged;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+
+    // Actions of the current step, or null when resetting.
+    const Action* pending_actions;
+    // Whether the worker threads should exit.
+    std::atomic<bool> stopping;
+    // Synchronizes the start and the end of each step with the worker threads.
+    std::barrier<> start_barrier;
+    std::barrier<> end_barrier;
+    std::vector<std::thread> workers;
+};
+
+}  // namespace ngames::mines
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ngames/mines/cell.hpp>
+
+#include <cstdint>
+
+
+namespace ngames::mines
+{
+
+/**
+ * Zobrist key of a cell state at a position, so that the hash of a board is
+ * the XOR of the keys of its cells, and changing a cell updates the hash in
+ * constant time. Keys are derived from the position and state by a mixing
+ * function instead of being drawn into a table, so boards of any size need
+ * no memory for them. State 0, i.e. an untouched cell, has key 0, so a new
+ * board hashes to 0.
+ * @param position Position of the cell, e.g. row * cols + col.
+ * @param cell State of the cell.
+ * @param seed Picks one of several independent families of keys.
+ */
+inline uint64_t zobrist_key(uint64_t position, Cell cell, uint64_t seed = 0)
+{
+    if (cell == 0) {
+        return 0;
+    }
+    // splitmix64 finalizer
+    uint64_t x = (position << 8 | cell) + (seed + 1) * 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+}  // namespace ngames::mines
@@ -0,0 +1,156 @@
+#include <ngames/mines_arena/bot_process.hpp>
+
+#include <algorithm>
+
+#include <cerrno>
+#include <csignal>
+
+#include <fcntl.h>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace ngames::mines_arena
+{
+
+BotProcess::BotProcess(const std::string& command) : pid(-1), input_fd(-1), output_fd(-1)
+{
+    // close-on-exec, so that bots started concurrently do not inherit each
+    // other's pipes and keep them open
+    int input_pipe[2];
+    int output_pipe[2];
+    if (pipe2(input_pipe, O_CLOEXEC) != 0) {
+        return;
+    }
+    if (pipe2(output_pipe, O_CLOEXEC) != 0) {
+        close(input_pipe[0]);
+        close(input_pipe[1]);
+        return;
+    }
+
+    pid = fork();
+    if (pid == 0) {
+        // child: connect pipes to stdin and stdout, then run the command in
+        // its own process group, so that it can be killed with any children
+        dup2(input_pipe[0], STDIN_FILENO);
+        dup2(output_pipe[1], STDOUT_FILENO);
+        setpgid(0, 0);
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    close(input_pipe[0]);
+    close(output_pipe[1]);
+    if (pid > 0) {
+        // also set the process group here, in case we kill the bot before it does
+        setpgid(pid, pid);
+    } else {
+        close(input_pipe[1]);
+        close(output_pipe[0]);
+        return;
+    }
+    input_fd = input_pipe[1];
+    output_fd = output_pipe[0];
+    // so that a bot that stops reading cannot block us past its deadline
+    fcntl(input_fd, F_SETFL, fcntl(input_fd, F_GETFL) | O_NONBLOCK);
+}
+
+BotProcess::~BotProcess()
+{
+    kill();
+}
+
+int BotProcess::send_line(std::string_view line, Clock::time_point deadline)
+{
+    if (!is_running()) {
+        return 2;
+    }
+    pending.assign(line);
+    pending += '\n';
+    size_t written = 0;
+    while (written < pending.size()) {
+        const ssize_t n = write(input_fd, pending.data() + written, pending.size() - written);
+        if (n >= 0) {
+            written += n;
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN) {
+            return 2;
+        }
+
+        // wait for the bot to read its input, until the deadline
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() < 0) {
+            return 1;
+        }
+        pollfd pfd = {.fd = input_fd, .events = POLLOUT, .revents = 0};
+        // round up, so that we do not spin just before the deadline
+        if (poll(&pfd, 1, static_cast<int>(remaining.count()) + 1) < 0 && errno != EINTR) {
+            return 2;
+        }
+    }
+    return 0;
+}
+
+int BotProcess::receive_line(std::string& line, Clock::time_point deadline)
+{
+    if (!is_running()) {
+        return 2;
+    }
+    size_t scanned = 0;
+    while (true) {
+        const size_t newline = buffer.find('\n', scanned);
+        if (newline != std::string::npos) {
+            line.assign(buffer, 0, newline);
+            buffer.erase(0, newline + 1);
+            return 0;
+        }
+        scanned = buffer.size();
+
+        // wait for more output, until the deadline
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() < 0) {
+            return 1;
+        }
+        pollfd pfd = {.fd = output_fd, .events = POLLIN, .revents = 0};
+        // round up, so that we do not spin just before the deadline
+        const int ready = poll(&pfd, 1, static_cast<int>(remaining.count()) + 1);
+        if (ready < 0) {
+            return 2;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        char chunk[4096];
+        const ssize_t n = read(output_fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            return 2;
+        }
+        buffer.append(chunk, n);
+    }
+}
+
+void BotProcess::kill()
+{
+    if (input_fd >= 0) {
+        close(input_fd);
+        input_fd = -1;
+    }
+    if (output_fd >= 0) {
+        close(output_fd);
+        output_fd = -1;
+    }
+    if (pid > 0) {
+        ::kill(-pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        pid = -1;
+    }
+}
+
+}  // namespace ngames::mines_arena
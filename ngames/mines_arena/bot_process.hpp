@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <sys/types.h>
+
+
+namespace ngames::mines_arena
+{
+
+/**
+ * External bot process, talking over its stdin and stdout one line at a time.
+ */
+class BotProcess
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Start the bot.
+     * @param command Shell command running the bot.
+     */
+    BotProcess(const std::string& command);
+
+    /**
+     * Kill the bot, if still running.
+     */
+    ~BotProcess();
+
+    BotProcess(const BotProcess&) = delete;
+    BotProcess& operator=(const BotProcess&) = delete;
+
+    /**
+     * Send a line to the bot.
+     * @param line Line, without the trailing newline.
+     * @param deadline Time to give up waiting for the bot to read its input,
+     * if the pipe is full.
+     * @returns Return code. A non-zero value means that the line may not have
+     * been sent whole. The possible error codes are
+     *   1: the deadline passed.
+     *   2: the bot closed its input, e.g. because it exited.
+     */
+    int send_line(std::string_view line, Clock::time_point deadline);
+
+    /**
+     * Receive a line from the bot.
+     * @param line Set to the line, without the trailing newline.
+     * @param deadline Time to give up waiting.
+     * @returns Return code. A non-zero value means that no line was received.
+     * The possible error codes are
+     *   1: the deadline passed.
+     *   2: the bot closed its output, e.g. because it exited.
+     */
+    int receive_line(std::string& line, Clock::time_point deadline);
+
+    /**
+     * Returns true if the bot was started.
+     */
+    inline bool is_running() const { return pid > 0; }
+
+private:
+    /**
+     * Kill the bot and wait for it to exit.
+     */
+    void kill();
+
+    pid_t pid;
+    // Write end of the bot's stdin, non-blocking.
+    int input_fd;
+    // Read end of the bot's stdout.
+    int output_fd;
+    // Bytes received from the bot after the last complete line.
+    std::string buffer;
+    // Line being sent to the bot, kept to avoid allocating.
+    std::string pending;
+};
+
+}  // namespace ngames::mines_arena
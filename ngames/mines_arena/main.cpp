@@ -0,0 +1,218 @@
+#include <ngames/mines_arena/tournament.hpp>
+
+#include <optional>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_arena [options] <bot command>...\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Plays each bot on the same seeded boards and reports win rates and move latencies.\n");
+    fprintf(stderr, "See ngames/mines_arena/tournament.hpp for the protocol bots must speak.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -b <r> <c> <m>         board size (default 16 30 99)\n");
+    fprintf(stderr, "  -n <games>             games per bot (default 100)\n");
+    fprintf(stderr, "  -s <seed>              seed of the first game (default 1)\n");
+    fprintf(stderr, "  -f <corpus>            deal the boards of a corpus made by mines --generate, instead of -b and -s\n");
+    fprintf(stderr, "  -t <ms>                time per bot per game, thinking or not reading replies (default 10000)\n");
+    fprintf(stderr, "  -j <jobs>              bots to run at once (default number of cores)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    ngames::mines_arena::Options options;
+    // Path of the corpus to deal boards from, if any.
+    const char* corpus = nullptr;
+    // Number of bots to run at once.
+    int jobs;
+    // Shell commands running the bots.
+    std::vector<std::string> commands;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+    args.jobs = std::max(1u, std::thread::hardware_concurrency());
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; ++i) {
+        const std::string arg = argv[i];
+        const int num_values = arg == "-b" ? 3 : 1;
+        if (i + num_values >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-b") {
+            args.options.rows = str_to_int(argv[++i]);
+            args.options.cols = str_to_int(argv[++i]);
+            args.options.mines = str_to_int(argv[++i]);
+        } else if (arg == "-n") {
+            args.options.games = str_to_int(argv[++i]);
+        } else if (arg == "-s") {
+            args.options.seed = str_to_int(argv[++i]);
+        } else if (arg == "-f") {
+            args.corpus = argv[++i];
+        } else if (arg == "-t") {
+            args.options.budget = std::chrono::milliseconds(str_to_int(argv[++i]));
+        } else if (arg == "-j") {
+            args.jobs = str_to_int(argv[++i]);
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        }
+    }
+    for (; i < argc; ++i) {
+        args.commands.emplace_back(argv[i]);
+    }
+
+    const auto& options = args.options;
+    if (static_cast<int64_t>(options.rows) * options.cols > INT_MAX) {
+        fprintf(stderr, "Too many cells (%d x %d); can be at most %d\n", options.rows, options.cols, INT_MAX);
+        help_and_exit();
+    }
+    if (options.rows < 1 || options.cols < 1 || options.mines < 0 || options.mines > options.rows * options.cols - 1) {
+        fprintf(stderr, "Invalid board size: %d %d %d\n", options.rows, options.cols, options.mines);
+        help_and_exit();
+    }
+    if (options.games < 1 || options.budget.count() < 1 || args.jobs < 1) {
+        fprintf(stderr, "Games, time and jobs must be positive.\n");
+        help_and_exit();
+    }
+    if (args.commands.empty()) {
+        fprintf(stderr, "No bots given.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+/**
+ * Print the results of a bot.
+ * @param index Index of the bot.
+ * @param command Shell command running the bot.
+ * @param report Results.
+ */
+static void print_report(int index, const std::string& command, const ngames::mines_arena::Report& report)
+{
+    const int games = report.wins + report.losses + report.timeouts + report.crashes;
+    printf("bot %d: %s\n", index, command.c_str());
+    printf("  games     %d\n", games);
+    printf("  wins      %d (%.1f%%)\n", report.wins, 100.0 * report.wins / games);
+    printf("  losses    %d\n", report.losses);
+    printf("  timeouts  %d\n", report.timeouts);
+    printf("  crashes   %d\n", report.crashes);
+    printf("  moves     %ld (%ld invalid)\n", report.moves, report.invalid_moves);
+
+    // print nanoseconds as microseconds
+    constexpr double scale = 1000.0;
+    for (const auto& [name, histogram] : {
+             std::pair<const char*, const ngames::Histogram&>{"latency", report.latency},
+             std::pair<const char*, const ngames::Histogram&>{"overhead", report.overhead},
+         }) {
+        printf(
+            "  %-9s p50 %.1fus  p90 %.1fus  p99 %.1fus  max %.1fus  mean %.1fus\n",
+            name,
+            histogram.percentile(50) / scale,
+            histogram.percentile(90) / scale,
+            histogram.percentile(99) / scale,
+            histogram.get_max() / scale,
+            histogram.get_mean() / scale);
+    }
+    printf("  latency histogram (us):\n");
+    report.latency.print(stdout, scale);
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+
+    // the corpus stays mapped while the bots play, and its header overrides
+    // the board options
+    auto options = args.options;
+    std::optional<ngames::mines::Corpus> corpus;
+    if (args.corpus != nullptr) {
+        corpus.emplace(args.corpus);
+        if (!corpus->is_open()) {
+            fprintf(stderr, "Invalid corpus: %s\n", args.corpus);
+            return EXIT_FAILURE;
+        }
+        const auto& header = corpus->get_header();
+        if (static_cast<uint64_t>(options.games) > header.count) {
+            fprintf(stderr, "Corpus has only %lu boards.\n", static_cast<unsigned long>(header.count));
+            return EXIT_FAILURE;
+        }
+        options.rows = header.rows;
+        options.cols = header.cols;
+        options.mines = header.mines;
+        options.corpus = &*corpus;
+    }
+
+    // a bot exiting early must not kill us when we write to it
+    signal(SIGPIPE, SIG_IGN);
+
+    // each bot plays its games on its own thread, with at most `jobs` at once
+    std::counting_semaphore<> slots(args.jobs);
+    std::vector<ngames::mines_arena::Report> reports(args.commands.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < args.commands.size(); ++i) {
+        threads.emplace_back([&, i] {
+            slots.acquire();
+            reports[i] = ngames::mines_arena::play_tournament(args.commands[i], options);
+            slots.release();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < args.commands.size(); ++i) {
+        print_report(i, args.commands[i], reports[i]);
+    }
+    return EXIT_SUCCESS;
+}
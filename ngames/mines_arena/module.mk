@@ -0,0 +1,14 @@
+mines_arena_sources := $(wildcard $(SRC)/mines_arena/*.cpp)
+mines_arena_objects := $(subst $(SRC),$(OBJ),$(mines_arena_sources:.cpp=.o))
+mines_arena_deps    := $(mines_arena_objects:.o=.d)
+
+apps    += $(BIN)/mines_arena
+sources += $(mines_arena_sources)
+objects += $(mines_arena_objects)
+deps    += $(mines_arena_deps)
+
+# plays games with the mines engine, without a terminal
+mines_arena_objects += $(OBJ)/mines/bot_protocol.o $(OBJ)/mines/cell_set.o $(OBJ)/mines/corpus.o $(OBJ)/mines/game.o $(OBJ)/mines/minesweeper.o $(OBJ)/mines/summary.o
+
+.PHONY: mines_arena
+mines_arena: $(BIN)/mines_arena
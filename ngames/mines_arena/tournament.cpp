@@ -0,0 +1,106 @@
+#include <ngames/mines_arena/tournament.hpp>
+
+#include <ngames/mines_arena/bot_process.hpp>
+
+#include <ngames/mines/bot_protocol.hpp>
+
+#include <memory>
+
+
+namespace
+{
+
+inline uint64_t elapsed_ns(ngames::mines_arena::BotProcess::Clock::time_point start)
+{
+    const auto elapsed = ngames::mines_arena::BotProcess::Clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+}  // namespace
+
+
+namespace ngames::mines_arena
+{
+
+Report play_tournament(const std::string& command, const Options& options)
+{
+    using Clock = BotProcess::Clock;
+
+    Report report;
+    mines::BotProtocol protocol(false);
+    std::unique_ptr<BotProcess> bot;
+    std::string line;
+    std::string reply;
+
+    const std::string game_line = "game " + std::to_string(options.rows) + " " + std::to_string(options.cols) + " " +
+                                  std::to_string(options.mines);
+
+    for (int game = 0; game < options.games; ++game) {
+        if (bot == nullptr) {
+            bot = std::make_unique<BotProcess>(command);
+        }
+        if (options.corpus != nullptr) {
+            protocol.new_game(options.rows,
+                              options.cols,
+                              options.mines,
+                              options.corpus->get_seed(game),
+                              options.corpus->get_layout(game));
+        } else {
+            protocol.new_game(options.rows, options.cols, options.mines, options.seed + game);
+        }
+
+        // only time spent waiting for the bot, to read its input or to send
+        // its moves, counts against its budget
+        auto budget = std::chrono::duration_cast<Clock::duration>(options.budget);
+        const auto send_time = Clock::now();
+        int code = bot->send_line(game_line, send_time + budget);
+        budget -= Clock::now() - send_time;
+        while (true) {
+            const auto start_time = Clock::now();
+            if (code == 0) {
+                code = bot->receive_line(line, start_time + budget);
+            }
+            if (code != 0) {
+                if (code == 1) {
+                    ++report.timeouts;
+                } else {
+                    ++report.crashes;
+                }
+                bot.reset();
+                break;
+            }
+            const uint64_t latency = elapsed_ns(start_time);
+            budget -= std::chrono::nanoseconds(latency);
+            report.latency.record(latency);
+            ++report.moves;
+
+            const auto handle_time = Clock::now();
+            protocol.handle(line, reply);
+            report.overhead.record(elapsed_ns(handle_time));
+            if (reply.find(" !") != std::string::npos) {
+                ++report.invalid_moves;
+            }
+
+            const auto reply_time = Clock::now();
+            code = bot->send_line(reply, reply_time + budget);
+            budget -= Clock::now() - reply_time;
+            const auto state = protocol.get_game()->get_state();
+            if (state != mines::Game::State::active) {
+                if (state == mines::Game::State::win) {
+                    ++report.wins;
+                } else {
+                    ++report.losses;
+                }
+                // the game is over, but a bot that did not take its last
+                // reply is restarted rather than blamed for the next game
+                if (code != 0) {
+                    bot.reset();
+                }
+                break;
+            }
+        }
+    }
+    return report;
+}
+
+}  // namespace ngames::mines_arena
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <ngames/common/histogram.hpp>
+
+#include <ngames/mines/corpus.hpp>
+
+#include <chrono>
+#include <string>
+
+
+namespace ngames::mines_arena
+{
+
+/**
+ * Settings shared by all bots in a tournament.
+ */
+struct Options {
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    // Number of games played by each bot.
+    int games = 100;
+    // Game `i` is played with seed `seed + i`, so every bot gets the same boards.
+    unsigned seed = 1;
+    // If set, game `i` is dealt board `i` of the corpus instead, and the
+    // settings above are taken from its header.
+    const mines::Corpus* corpus = nullptr;
+    // Time each bot may spend per game, thinking or leaving its replies
+    // unread, summed over all moves.
+    std::chrono::milliseconds budget{10000};
+};
+
+/**
+ * Results of one bot.
+ */
+struct Report {
+    int wins = 0;
+    int losses = 0;
+    // Games where the bot ran out of time.
+    int timeouts = 0;
+    // Games where the bot exited or closed its output.
+    int crashes = 0;
+    // Lines of commands received.
+    long moves = 0;
+    // Lines with at least one failed command.
+    long invalid_moves = 0;
+    // Nanoseconds from sending a reply until receiving the next move.
+    Histogram latency;
+    // Nanoseconds spent by the harness applying each move.
+    Histogram overhead;
+};
+
+/**
+ * Play all games of a tournament with one bot.
+ *
+ * For each game, the bot is sent a line `game <rows> <cols> <mines>`. It then
+ * sends moves, i.e. request lines of the bot protocol (see
+ * `ngames/mines/bot_protocol.hpp`) except that `new` is forbidden, and gets a
+ * reply line for each. Once a reply reports `win` or `lose`, the next game
+ * starts. After the last game, the bot's input is closed. A bot that times
+ * out or crashes is restarted for the next game.
+ *
+ * @param command Shell command running the bot.
+ * @param options Tournament settings.
+ */
+Report play_tournament(const std::string& command, const Options& options);
+
+}  // namespace ngames::mines_arena
@@ -0,0 +1,550 @@
+#include <ngames/mines/game.hpp>
+#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/vec_env.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace
+{
+
+// Number of allocations made so far, counted by the replaced `operator new`.
+// NOTE: atomic, since the batched games are stepped on several threads
+std::atomic<uint64_t> num_allocs = 0;
+
+}  // namespace
+
+
+// NOTE: not inlined, as GCC then warns that `free()` is called on the result
+// of `new`
+[[gnu::noinline]] void* operator new(size_t size)
+{
+    num_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+namespace
+{
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_bench [options]\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Benchmarks the operations of the mines engine on seeded boards from 9x9 up to 10000x10000, and\n");
+    fprintf(stderr, "prints the time and allocations per operation as JSON. Batches of games are stepped on one thread\n");
+    fprintf(stderr, "and on several, and the benchmark fails if the two leave different observations.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -m <rows>              largest board size, in rows (default 10000)\n");
+    fprintf(stderr, "  -t <ms>                least time measured per benchmark (default 200)\n");
+    fprintf(stderr, "  -s <seed>              seed of the boards (default 1)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    // Boards with more rows than this are skipped.
+    int max_rows = 10000;
+    // Each benchmark runs until its timed parts add up to this.
+    int min_ms = 200;
+    unsigned seed = 1;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+Args get_args(int argc, char** argv)
+{
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h") {
+            help_and_exit();
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-m") {
+            args.max_rows = str_to_int(argv[++i]);
+        } else if (arg == "-t") {
+            args.min_ms = str_to_int(argv[++i]);
+        } else if (arg == "-s") {
+            args.seed = str_to_int(argv[++i]);
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        }
+    }
+
+    if (args.max_rows < 1 || args.min_ms < 0) {
+        fprintf(stderr, "Rows and time must be positive.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+// Most cells opened or chorded per iteration.
+constexpr int MAX_CELLS = 1 << 16;
+// Most cells of a batch of games, summed over its games. Larger boards are
+// not stepped in batches.
+constexpr int MAX_BATCH_CELLS = 1 << 22;
+// Most games of a batch.
+constexpr int MAX_BATCH_ENVS = 1024;
+// Steps of a batch per iteration.
+constexpr int BATCH_STEPS = 64;
+
+struct Board {
+    int rows;
+    int cols;
+    int mines;
+};
+
+/**
+ * Measures a benchmark, whose iterations each run an untimed setup and then
+ * timed operations, and prints its result as a JSON object.
+ */
+class Runner
+{
+public:
+    Runner(const Args& args) : min_time(std::chrono::milliseconds(args.min_ms)) {}
+
+    /**
+     * Run a benchmark until its timed parts add up to the least time, or
+     * until its setups alone take several times that, but at least once.
+     * @param name Name of the benchmark.
+     * @param board Board size.
+     * @param setup Prepares an iteration, untimed.
+     * @param run Runs the timed operations of an iteration, returning how many
+     * it ran.
+     */
+    void run(
+        const char* name, const Board& board, const std::function<void()>& setup, const std::function<long()>& run)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        Clock::duration elapsed = Clock::duration::zero();
+        long iterations = 0;
+        long ops = 0;
+        uint64_t allocs = 0;
+        do {
+            setup();
+            const uint64_t allocs_start = num_allocs;
+            const Clock::time_point run_start = Clock::now();
+            ops += run();
+            elapsed += Clock::now() - run_start;
+            allocs += num_allocs - allocs_start;
+            ++iterations;
+        } while (elapsed < min_time && Clock::now() - start < MAX_SETUP_FACTOR * min_time);
+
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        printf("%s\n    {\"name\": \"%s\", \"rows\": %d, \"cols\": %d, \"mines\": %d, \"iterations\": %ld, "
+               "\"ops\": %ld, \"ns_per_op\": %.1f, \"allocs_per_op\": %.3f}",
+               num_results > 0 ? "," : "",
+               name,
+               board.rows,
+               board.cols,
+               board.mines,
+               iterations,
+               ops,
+               ops > 0 ? ns / ops : 0.0,
+               ops > 0 ? static_cast<double>(allocs) / ops : 0.0);
+        fflush(stdout);
+        ++num_results;
+    }
+
+private:
+    // Benchmarks whose setup dominates stop once the whole run takes this many
+    // times the least time.
+    static constexpr int MAX_SETUP_FACTOR = 5;
+
+    const std::chrono::steady_clock::duration min_time;
+    int num_results = 0;
+};
+
+/**
+ * Benchmark drawing the mines of a board, at several densities.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size; its number of mines is ignored.
+ */
+void bench_populate_mines(Runner& runner, const Args& args, const Board& board)
+{
+    for (const double density : {0.01, 0.15, 0.5}) {
+        const Board dense = {board.rows, board.cols, static_cast<int>(density * board.rows * board.cols)};
+        ngames::mines::Minesweeper minesweeper(dense.rows, dense.cols, dense.mines);
+        unsigned seed = args.seed;
+        // NOTE: resetting also clears the board, which is cheap next to drawing
+        // the mines
+        runner.run("populate_mines", dense, [] {}, [&] {
+            minesweeper.reset(seed++);
+            return 1;
+        });
+    }
+}
+
+/**
+ * Benchmark the first click of a game, which moves the mines away from the
+ * clicked cell and opens it, usually along with a region around it.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_first_click(Runner& runner, const Args& args, const Board& board)
+{
+    ngames::mines::Game game(board.rows, board.cols, board.mines);
+    unsigned seed = args.seed;
+    runner.run("first_click", board, [&] { game.reset(seed++); }, [&] {
+        game.click_cell(board.rows / 2, board.cols / 2);
+        return 1;
+    });
+}
+
+/**
+ * Benchmark opening single safe cells in the back-end, which counts their
+ * neighboring mines.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_count_neighbor_mines(Runner& runner, const Args& args, const Board& board)
+{
+    // open the safe cells spread evenly over the board, but not all of them,
+    // so the game is not won
+    const std::vector<bool> is_mine =
+        ngames::mines::Minesweeper::layout(board.rows, board.cols, board.mines, args.seed, 0, 0);
+    const int num_safe = board.rows * board.cols - board.mines - 2;
+    const int step = std::max(1, num_safe / MAX_CELLS);
+    std::vector<int> cells;
+    for (int idx = 1, safe = 0; idx < board.rows * board.cols && safe < num_safe; ++idx) {
+        if (!is_mine[idx] && safe++ % step == 0) {
+            cells.push_back(idx);
+        }
+    }
+
+    ngames::mines::Minesweeper minesweeper(board.rows, board.cols, board.mines);
+    int neighbor_mine_count;
+    long sum = 0;
+    runner.run("count_neighbor_mines", board, [&] {
+        minesweeper.reset(args.seed);
+        minesweeper.open(0, 0, neighbor_mine_count);
+    }, [&] {
+        for (const int idx : cells) {
+            minesweeper.open(idx / board.cols, idx % board.cols, neighbor_mine_count);
+            sum += neighbor_mine_count;
+        }
+        return static_cast<long>(cells.size());
+    });
+    // NOTE: use the counts, so they are not optimized away
+    if (sum < 0) {
+        printf("%ld", sum);
+    }
+}
+
+/**
+ * Benchmark opening a board without mines with a single click, i.e. a flood
+ * fill over every cell. Operations are cells opened.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size; its number of mines is ignored.
+ */
+void bench_flood_fill(Runner& runner, const Args& args, const Board& board)
+{
+    const Board empty = {board.rows, board.cols, 0};
+    ngames::mines::Game game(empty.rows, empty.cols, empty.mines);
+    runner.run("flood_fill", empty, [&] { game.reset(args.seed); }, [&] {
+        game.click_cell(empty.rows / 2, empty.cols / 2);
+        return static_cast<long>(game.get_num_opened());
+    });
+}
+
+/**
+ * Benchmark chording opened cells spread evenly over the board, after flagging
+ * their neighboring mines. Operations are chords, i.e. clicks on opened cells
+ * that open their unflagged neighbors.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_chord(Runner& runner, const Args& args, const Board& board)
+{
+    const int first_row = board.rows / 2;
+    const int first_col = board.cols / 2;
+    const std::vector<bool> is_mine =
+        ngames::mines::Minesweeper::layout(board.rows, board.cols, board.mines, args.seed, first_row, first_col);
+
+    // chord the safe cells next to both mines and other safe cells
+    std::vector<int> candidates;
+    for (int row = 0; row < board.rows; ++row) {
+        for (int col = 0; col < board.cols; ++col) {
+            if (is_mine[row * board.cols + col]) {
+                continue;
+            }
+            int neighbor_mines = 0;
+            int neighbor_safe = 0;
+            for (int r = std::max(0, row - 1); r <= std::min(board.rows - 1, row + 1); ++r) {
+                for (int c = std::max(0, col - 1); c <= std::min(board.cols - 1, col + 1); ++c) {
+                    neighbor_mines += is_mine[r * board.cols + c];
+                    neighbor_safe += !is_mine[r * board.cols + c];
+                }
+            }
+            if (neighbor_mines > 0 && neighbor_safe > 1) {
+                candidates.push_back(row * board.cols + col);
+            }
+        }
+    }
+    const int step = std::max(1, static_cast<int>(candidates.size()) / MAX_CELLS);
+    std::vector<int> cells;
+    for (size_t i = 0; i < candidates.size(); i += step) {
+        cells.push_back(candidates[i]);
+    }
+
+    ngames::mines::Game game(board.rows, board.cols, board.mines);
+    runner.run("chord", board, [&] {
+        game.reset(args.seed);
+        game.click_cell(first_row, first_col);
+        for (const int idx : cells) {
+            const int row = idx / board.cols;
+            const int col = idx % board.cols;
+            if (!game.is_opened(row, col)) {
+                game.click_cell(row, col);
+            }
+            for (int r = std::max(0, row - 1); r <= std::min(board.rows - 1, row + 1); ++r) {
+                for (int c = std::max(0, col - 1); c <= std::min(board.cols - 1, col + 1); ++c) {
+                    if (is_mine[r * board.cols + c] && !game.is_flagged(r, c)) {
+                        game.toggle_flag(r, c);
+                    }
+                }
+            }
+        }
+    }, [&] {
+        // NOTE: a chord may open the neighbors of later cells, which then
+        // cannot be chorded
+        long chords = 0;
+        for (const int idx : cells) {
+            chords += game.click_cell(idx / board.cols, idx % board.cols) == 0;
+        }
+        return chords;
+    });
+}
+
+/**
+ * Benchmark resetting a game, which clears the board and draws new mines.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_reset(Runner& runner, const Args& args, const Board& board)
+{
+    ngames::mines::Game game(board.rows, board.cols, board.mines);
+    unsigned seed = args.seed;
+    runner.run("reset", board, [] {}, [&] {
+        game.reset(seed++);
+        return 1;
+    });
+}
+
+/**
+ * Benchmark opening a mine after the first click, which ends the game and
+ * reveals every mine.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_reveal(Runner& runner, const Args& args, const Board& board)
+{
+    const int first_row = board.rows / 2;
+    const int first_col = board.cols / 2;
+    const std::vector<bool> is_mine =
+        ngames::mines::Minesweeper::layout(board.rows, board.cols, board.mines, args.seed, first_row, first_col);
+    const int mine = std::find(is_mine.begin(), is_mine.end(), true) - is_mine.begin();
+
+    ngames::mines::Game game(board.rows, board.cols, board.mines);
+    runner.run("reveal", board, [&] {
+        game.reset(args.seed);
+        game.click_cell(first_row, first_col);
+    }, [&] {
+        game.click_cell(mine / board.cols, mine % board.cols);
+        return 1;
+    });
+}
+
+/**
+ * Step a new batch of games through a sequence of actions, and return a hash
+ * of its observations, rewards and done flags after every step.
+ * @param board Board size.
+ * @param num_envs Number of games.
+ * @param num_threads Number of threads stepping the games.
+ * @param seed Seed of the batch.
+ * @param actions `BATCH_STEPS` arrays of `num_envs` actions.
+ */
+uint64_t hash_vec_env(const Board& board,
+                      int num_envs,
+                      int num_threads,
+                      unsigned seed,
+                      const std::vector<ngames::mines::VecEnv::Action>& actions)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325;
+    const auto add = [&](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3;
+        }
+    };
+
+    ngames::mines::VecEnv env(num_envs, board.rows, board.cols, board.mines, seed, num_threads);
+    const size_t num_cells = static_cast<size_t>(num_envs) * board.rows * board.cols;
+    for (int step = 0; step < BATCH_STEPS; ++step) {
+        env.step(&actions[static_cast<size_t>(step) * num_envs]);
+        add(env.get_numbers(), num_cells);
+        add(env.get_opened(), num_cells);
+        add(env.get_flagged(), num_cells);
+        add(env.get_rewards(), num_envs * sizeof(float));
+        add(env.get_dones(), num_envs);
+    }
+    return hash;
+}
+
+/**
+ * Benchmark stepping a batch of games with seeded random actions, on one
+ * thread and on several. Operations are steps of a single game. Exits the
+ * program if the games are not stepped the same regardless of the number of
+ * threads.
+ * @param runner Runner.
+ * @param args Arguments.
+ * @param board Board size.
+ */
+void bench_vec_env(Runner& runner, const Args& args, const Board& board)
+{
+    const int num_cells = board.rows * board.cols;
+    if (num_cells > MAX_BATCH_CELLS) {
+        return;
+    }
+    const int num_envs = std::min(MAX_BATCH_ENVS, MAX_BATCH_CELLS / num_cells);
+
+    // mostly clicks, which end most games within a few steps, and some flags
+    std::mt19937 rng(args.seed);
+    std::vector<ngames::mines::VecEnv::Action> actions(static_cast<size_t>(BATCH_STEPS) * num_envs);
+    for (auto& action : actions) {
+        action.cell = static_cast<int32_t>(rng() % num_cells);
+        action.type = rng() % 8 == 0 ? ngames::mines::VecEnv::flag : ngames::mines::VecEnv::click;
+    }
+
+    const int max_threads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+    if (hash_vec_env(board, num_envs, 1, args.seed, actions) !=
+        hash_vec_env(board, num_envs, max_threads, args.seed, actions)) {
+        fprintf(stderr,
+                "\nBatch of %d %dx%d games stepped differently on 1 and %d threads\n",
+                num_envs,
+                board.rows,
+                board.cols,
+                max_threads);
+        exit(EXIT_FAILURE);
+    }
+
+    for (const int num_threads : {1, max_threads}) {
+        ngames::mines::VecEnv env(num_envs, board.rows, board.cols, board.mines, args.seed, num_threads);
+        const std::string name = "vec_env_step_threads_" + std::to_string(num_threads);
+        runner.run(name.c_str(), board, [] {}, [&] {
+            for (int step = 0; step < BATCH_STEPS; ++step) {
+                env.step(&actions[static_cast<size_t>(step) * num_envs]);
+            }
+            return static_cast<long>(BATCH_STEPS) * num_envs;
+        });
+    }
+}
+
+}  // namespace
+
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+
+    // beginner and expert boards, and then huge ones with the density of expert
+    const std::vector<Board> boards = {
+        {9, 9, 10},
+        {16, 30, 99},
+        {100, 100, 2000},
+        {1000, 1000, 200000},
+        {10000, 10000, 20000000},
+    };
+
+    Runner runner(args);
+    printf("{\n  \"benchmarks\": [");
+    for (const Board& board : boards) {
+        if (board.rows > args.max_rows) {
+            continue;
+        }
+        bench_populate_mines(runner, args, board);
+        bench_first_click(runner, args, board);
+        bench_count_neighbor_mines(runner, args, board);
+        bench_flood_fill(runner, args, board);
+        bench_chord(runner, args, board);
+        bench_reset(runner, args, board);
+        bench_reveal(runner, args, board);
+        bench_vec_env(runner, args, board);
+    }
+    printf("\n  ]\n}\n");
+    return EXIT_SUCCESS;
+}
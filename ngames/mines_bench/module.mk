@@ -0,0 +1,23 @@
+mines_bench_sources := $(wildcard $(SRC)/mines_bench/*.cpp)
+mines_bench_objects := $(subst $(SRC),$(OBJ),$(mines_bench_sources:.cpp=.o))
+mines_bench_deps    := $(mines_bench_objects:.o=.d)
+
+apps    += $(BIN)/mines_bench
+sources += $(mines_bench_sources)
+objects += $(mines_bench_objects)
+deps    += $(mines_bench_deps)
+
+# benchmarks the mines engine alone, so unlike the other apps it links neither
+# the common objects nor ncurses
+mines_bench_objects += $(OBJ)/mines/cell_set.o $(OBJ)/mines/game.o $(OBJ)/mines/minesweeper.o $(OBJ)/mines/summary.o $(OBJ)/mines/vec_env.o
+
+$(BIN)/mines_bench: $(mines_bench_objects)
+	@mkdir -p $(@D)
+	$(CXX) $(LDFLAGS) $^ -o $@
+
+.PHONY: mines_bench
+mines_bench: $(BIN)/mines_bench
+
+.PHONY: bench-mines
+bench-mines: $(BIN)/mines_bench
+	@$(BIN)/mines_bench
@@ -0,0 +1,326 @@
+#include <ngames/common/histogram.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_load [options] <socket>\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Plays random sessions against a mines_server and reports throughput and move latencies.\n");
+    fprintf(stderr, "Each session connects, plays a number of moves, starting new games as needed, and disconnects.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -b <r> <c> <m>         board size (default 16 30 99)\n");
+    fprintf(stderr, "  -c <clients>           sessions to play at once (default 16)\n");
+    fprintf(stderr, "  -n <sessions>          sessions to play in total (default 1000)\n");
+    fprintf(stderr, "  -m <moves>             moves per session (default 100)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    // Path of the server socket.
+    const char* path = nullptr;
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    // Number of sessions played at once.
+    int clients = 16;
+    // Number of sessions played in total.
+    int sessions = 1000;
+    // Number of moves per session.
+    int moves = 100;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const int num_values = arg == "-b" ? 3 : 1;
+        if (arg[0] == '-' && i + num_values >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-b") {
+            args.rows = str_to_int(argv[++i]);
+            args.cols = str_to_int(argv[++i]);
+            args.mines = str_to_int(argv[++i]);
+        } else if (arg == "-c") {
+            args.clients = str_to_int(argv[++i]);
+        } else if (arg == "-n") {
+            args.sessions = str_to_int(argv[++i]);
+        } else if (arg == "-m") {
+            args.moves = str_to_int(argv[++i]);
+        } else if (arg[0] == '-' || args.path != nullptr) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        } else {
+            args.path = argv[i];
+        }
+    }
+
+    if (args.path == nullptr) {
+        help_and_exit();
+    }
+    if (args.rows < 1 || args.cols < 1 || args.mines < 0 || static_cast<int64_t>(args.rows) * args.cols > INT_MAX ||
+        args.mines > args.rows * args.cols - 1) {
+        fprintf(stderr, "Invalid board size: %d %d %d\n", args.rows, args.cols, args.mines);
+        help_and_exit();
+    }
+    if (args.clients < 1 || args.sessions < 1 || args.moves < 1) {
+        fprintf(stderr, "Clients, sessions and moves must be positive.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+/**
+ * Blocking connection to the server, sending requests and waiting for their
+ * replies.
+ */
+class Connection
+{
+public:
+    /**
+     * Connect to the server. Check `is_open()` for success.
+     * @param path Path of the server socket.
+     */
+    Connection(const char* path) : fd(socket(AF_UNIX, SOCK_STREAM, 0))
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    ~Connection()
+    {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    inline bool is_open() const { return fd >= 0; }
+
+    /**
+     * Send a request and wait for its reply.
+     * @param request Request line, including the trailing newline.
+     * @param reply Set to the reply line, without the trailing newline.
+     * @returns False if the connection failed.
+     */
+    bool request(std::string_view request, std::string& reply)
+    {
+        while (!request.empty()) {
+            const ssize_t sent = send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent <= 0) {
+                return false;
+            }
+            request.remove_prefix(sent);
+        }
+
+        size_t end;
+        while ((end = buffer.find('\n')) == std::string::npos) {
+            char chunk[4096];
+            const ssize_t length = read(fd, chunk, sizeof(chunk));
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+            if (length <= 0) {
+                return false;
+            }
+            buffer.append(chunk, length);
+        }
+        reply.assign(buffer, 0, end);
+        buffer.erase(0, end + 1);
+        return true;
+    }
+
+private:
+    int fd;
+    // Received data not returned yet.
+    std::string buffer;
+};
+
+/**
+ * Results of a client thread.
+ */
+struct Results {
+    long sessions = 0;
+    long moves = 0;
+    long errors = 0;
+    // Move latencies, in nanoseconds.
+    ngames::Histogram latencies;
+};
+
+/**
+ * Play sessions until all have been started by some client.
+ * @param args Arguments.
+ * @param next_session Number of sessions started by all clients.
+ * @param seed Seed for picking moves.
+ * @param results Set to the results.
+ */
+static void run_client(const Args& args, std::atomic<int>& next_session, unsigned seed, Results& results)
+{
+    std::mt19937 rng(seed);
+    const std::string new_game =
+        "new " + std::to_string(args.rows) + " " + std::to_string(args.cols) + " " + std::to_string(args.mines) + "\n";
+    std::string request;
+    std::string reply;
+    // cells not opened yet in the current game, and their index in that list
+    // NOTE: we encode the pair (row, col) as a single integer: row * cols + col
+    std::vector<int> unopened;
+    std::vector<int> positions(args.rows * args.cols);
+
+    while (next_session.fetch_add(1) < args.sessions) {
+        Connection connection(args.path);
+        bool ok = connection.is_open();
+        bool active = false;
+        for (int move = 0; ok && move < args.moves;) {
+            if (!active) {
+                ok = connection.request(new_game, reply);
+                unopened.resize(args.rows * args.cols);
+                std::iota(unopened.begin(), unopened.end(), 0);
+                std::iota(positions.begin(), positions.end(), 0);
+                active = true;
+                continue;
+            }
+
+            // open a random unopened cell
+            const int idx_idx = rng() % unopened.size();
+            const int idx = unopened[idx_idx];
+            request = "open " + std::to_string(idx / args.cols) + " " + std::to_string(idx % args.cols) + "\n";
+            const auto start = std::chrono::steady_clock::now();
+            ok = connection.request(request, reply);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            results.latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            ++results.moves;
+            ++move;
+
+            // forget the cells opened by the move, e.g. by a flood fill; we
+            // never flag, so all changed cells have been opened
+            for (size_t pos = reply.find(' '); pos != std::string::npos; pos = reply.find(' ', pos + 1)) {
+                int row, col;
+                if (sscanf(reply.c_str() + pos + 1, "%d,%d,", &row, &col) != 2) {
+                    continue;
+                }
+                const int cell = row * args.cols + col;
+                if (positions[cell] < 0) {
+                    continue;
+                }
+                // remove in O(1) time by replacing it with the last cell of the list
+                unopened[positions[cell]] = unopened.back();
+                positions[unopened.back()] = positions[cell];
+                unopened.pop_back();
+                positions[cell] = -1;
+            }
+            active = reply.starts_with("active") && !unopened.empty();
+        }
+        if (ok) {
+            ++results.sessions;
+        } else {
+            ++results.errors;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+
+    std::atomic<int> next_session = 0;
+    std::vector<Results> results(args.clients);
+    std::vector<std::thread> clients;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < args.clients; ++i) {
+        clients.emplace_back(run_client, std::cref(args), std::ref(next_session), i, std::ref(results[i]));
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Results total;
+    for (const auto& result : results) {
+        total.sessions += result.sessions;
+        total.moves += result.moves;
+        total.errors += result.errors;
+        total.latencies.merge(result.latencies);
+    }
+    printf(
+        "sessions=%ld errors=%ld time_s=%.3f sessions_per_s=%.1f moves=%ld moves_per_s=%.1f "
+        "p50_us=%.1f p99_us=%.1f max_us=%.1f\n",
+        total.sessions,
+        total.errors,
+        elapsed_s,
+        total.sessions / elapsed_s,
+        total.moves,
+        total.moves / elapsed_s,
+        total.latencies.percentile(50) / 1e3,
+        total.latencies.percentile(99) / 1e3,
+        total.latencies.get_max() / 1e3);
+    return total.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
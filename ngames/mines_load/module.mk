@@ -0,0 +1,11 @@
+mines_load_sources := $(wildcard $(SRC)/mines_load/*.cpp)
+mines_load_objects := $(subst $(SRC),$(OBJ),$(mines_load_sources:.cpp=.o))
+mines_load_deps    := $(mines_load_objects:.o=.d)
+
+apps    += $(BIN)/mines_load
+sources += $(mines_load_sources)
+objects += $(mines_load_objects)
+deps    += $(mines_load_deps)
+
+.PHONY: mines_load
+mines_load: $(BIN)/mines_load
@@ -0,0 +1,280 @@
+#include <ngames/mines/board.hpp>
+#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/ui.hpp>
+
+#include <ngames/common/border.hpp>
+
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/stat.h>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_render [options]\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Plays seeded keystrokes on a mines board rendered to a temporary file instead of a terminal, and\n");
+    fprintf(stderr, "reports the cost of refreshing the screen after each keystroke, when redrawing the whole board and\n");
+    fprintf(stderr, "when redrawing only the changed cells. Fails if the two leave different screens. Then reports the\n");
+    fprintf(stderr, "throughput of drawing the whole board into its window.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -b <r> <c> <m>         board size (default 1000 1000 150000)\n");
+    fprintf(stderr, "  -n <keystrokes>        keystrokes to play (default 1000)\n");
+    fprintf(stderr, "  -r <redraws>           whole-board redraws to time (default 100)\n");
+    fprintf(stderr, "  -s <seed>              seed of the board and keystrokes (default 1)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    int rows = 1000;
+    int cols = 1000;
+    int mines = 150000;
+    // Number of keystrokes to play.
+    int keystrokes = 1000;
+    // Number of whole-board redraws to time.
+    int redraws = 100;
+    // Seed of the board and of the keystrokes.
+    unsigned seed = 1;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h") {
+            help_and_exit();
+        }
+        const int num_values = arg == "-b" ? 3 : 1;
+        if (i + num_values >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-b") {
+            args.rows = str_to_int(argv[++i]);
+            args.cols = str_to_int(argv[++i]);
+            args.mines = str_to_int(argv[++i]);
+        } else if (arg == "-n") {
+            args.keystrokes = str_to_int(argv[++i]);
+        } else if (arg == "-r") {
+            args.redraws = str_to_int(argv[++i]);
+        } else if (arg == "-s") {
+            args.seed = str_to_int(argv[++i]);
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        }
+    }
+
+    if (args.rows < 1 || args.cols < 1 || args.mines < 0 || static_cast<int64_t>(args.rows) * args.cols > INT_MAX ||
+        args.mines > args.rows * args.cols - 1) {
+        fprintf(stderr, "Invalid board size: %d %d %d\n", args.rows, args.cols, args.mines);
+        help_and_exit();
+    }
+    if (args.keystrokes < 1 || args.redraws < 1) {
+        fprintf(stderr, "Keystrokes and redraws must be positive.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+/**
+ * Keystroke at a cell.
+ */
+struct Keystroke {
+    int row;
+    int col;
+    // Whether the keystroke toggles a flag, rather than opening the cell.
+    bool flag;
+};
+
+/**
+ * Generate keystrokes like a player's: toggling flags on, and opening, random
+ * safe cells, so that every keystroke changes the board.
+ * @param args Arguments.
+ * @param is_mine Layout of the mines.
+ */
+static std::vector<Keystroke> make_keystrokes(const Args& args, const std::vector<bool>& is_mine)
+{
+    std::vector<Keystroke> keystrokes;
+    std::mt19937 rng(args.seed);
+    while (static_cast<int>(keystrokes.size()) < args.keystrokes) {
+        const int idx = rng() % (args.rows * args.cols);
+        if (!is_mine[idx]) {
+            keystrokes.push_back({.row = idx / args.cols, .col = idx % args.cols, .flag = rng() % 2 == 0});
+        }
+    }
+    return keystrokes;
+}
+
+/**
+ * Return the characters and attributes displayed by a window.
+ * @param window Window.
+ */
+static std::vector<chtype> capture(WINDOW* window)
+{
+    std::vector<chtype> screen;
+    for (int row = 0; row < getmaxy(window); ++row) {
+        for (int col = 0; col < getmaxx(window); ++col) {
+            screen.push_back(mvwinch(window, row, col));
+        }
+    }
+    return screen;
+}
+
+/**
+ * Return the size of a file.
+ * @param file File.
+ */
+static long file_size(FILE* file)
+{
+    struct stat st;
+    return fstat(fileno(file), &st) == 0 ? st.st_size : 0;
+}
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+
+    // render to a temporary file with a screen large enough for the board
+    FILE* output = tmpfile();
+    FILE* input = fopen("/dev/null", "r");
+    if (output == nullptr || input == nullptr) {
+        perror("mines_render");
+        return EXIT_FAILURE;
+    }
+    setenv("LINES", std::to_string(args.rows + 2).c_str(), 1);
+    setenv("COLUMNS", std::to_string(args.cols + 2).c_str(), 1);
+    SCREEN* screen = newterm("xterm-256color", output, input);
+    if (screen == nullptr) {
+        fprintf(stderr, "Cannot create screen.\n");
+        return EXIT_FAILURE;
+    }
+    ngames::mines::init_colors();
+
+    ngames::Border board_border(args.rows, args.cols, 0, 0);
+    ngames::mines::Board board(args.rows,
+                               args.cols,
+                               args.mines,
+                               args.seed,
+                               board_border.inner_start_y(),
+                               board_border.inner_start_x(),
+                               board_border.window);
+    const int first_row = args.rows / 2;
+    const int first_col = args.cols / 2;
+    const std::vector<bool> is_mine =
+        ngames::mines::Minesweeper::layout(args.rows, args.cols, args.mines, args.seed, first_row, first_col);
+    const std::vector<Keystroke> keystrokes = make_keystrokes(args, is_mine);
+
+    std::vector<chtype> screens[2];
+    for (const bool incremental : {false, true}) {
+        board.reset(args.seed);
+        board.click_cell(first_row, first_col);
+        board.redraw();
+        board_border.refresh();
+        board.refresh();
+        doupdate();
+
+        double elapsed_ms = 0;
+        const long start_size = file_size(output);
+        for (const Keystroke& keystroke : keystrokes) {
+            if (keystroke.flag) {
+                board.toggle_flag(keystroke.row, keystroke.col);
+            } else {
+                board.click_cell(keystroke.row, keystroke.col);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            if (!incremental) {
+                board.redraw();
+            }
+            board.refresh();
+            doupdate();
+            elapsed_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        screens[incremental] = capture(board.window);
+
+        printf("mode=%s rows=%d cols=%d keystrokes=%d us_per_keystroke=%.2f bytes_per_keystroke=%.1f\n",
+               incremental ? "incremental" : "full",
+               args.rows,
+               args.cols,
+               args.keystrokes,
+               elapsed_ms * 1000 / args.keystrokes,
+               static_cast<double>(file_size(output) - start_size) / args.keystrokes);
+    }
+
+    // the board is left as played, with a mix of every kind of cell; time
+    // drawing it into the window only, since the terminal output is the same
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < args.redraws; ++i) {
+        board.redraw();
+        board.refresh();
+    }
+    const double elapsed_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const double cells = static_cast<double>(args.rows) * args.cols * args.redraws;
+    printf("mode=redraw rows=%d cols=%d redraws=%d ns_per_cell=%.2f mcells_per_s=%.1f\n",
+           args.rows,
+           args.cols,
+           args.redraws,
+           elapsed_ns / cells,
+           cells / elapsed_ns * 1000);
+
+    endwin();
+    delscreen(screen);
+    fclose(output);
+    fclose(input);
+
+    const bool identical = screens[0] == screens[1];
+    printf("identical=%d\n", identical);
+    if (!identical) {
+        fprintf(stderr, "Incremental refreshes left a different screen than full redraws.\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
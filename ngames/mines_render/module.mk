@@ -0,0 +1,14 @@
+mines_render_sources := $(wildcard $(SRC)/mines_render/*.cpp)
+mines_render_objects := $(subst $(SRC),$(OBJ),$(mines_render_sources:.cpp=.o))
+mines_render_deps    := $(mines_render_objects:.o=.d)
+
+apps    += $(BIN)/mines_render
+sources += $(mines_render_sources)
+objects += $(mines_render_objects)
+deps    += $(mines_render_deps)
+
+# renders the mines board to a file instead of a terminal
+mines_render_objects += $(OBJ)/mines/board.o $(OBJ)/mines/cell_set.o $(OBJ)/mines/game.o $(OBJ)/mines/minesweeper.o $(OBJ)/mines/summary.o
+
+.PHONY: mines_render
+mines_render: $(BIN)/mines_render
@@ -0,0 +1,83 @@
+#include <ngames/mines_server/server.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <cstring>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_server [options] <socket>\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Hosts independent Minesweeper games on a Unix socket, one per connection.\n");
+    fprintf(stderr, "Clients speak the bot protocol, see ngames/mines/bot_protocol.hpp.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -j <threads>           worker threads (default number of cores)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+int main(int argc, char** argv)
+{
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            num_threads = str_to_int(argv[++i]);
+            if (num_threads < 1) {
+                fprintf(stderr, "Threads must be positive.\n");
+                help_and_exit();
+            }
+        } else if (arg[0] == '-' || path != nullptr) {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        help_and_exit();
+    }
+
+    ngames::mines_server::Server server(num_threads);
+    if (!server.is_open()) {
+        perror("epoll");
+        return EXIT_FAILURE;
+    }
+    printf("Serving on %s with %d threads\n", path, num_threads);
+    fflush(stdout);
+    return server.run(path) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
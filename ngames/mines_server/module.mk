@@ -0,0 +1,14 @@
+mines_server_sources := $(wildcard $(SRC)/mines_server/*.cpp)
+mines_server_objects := $(subst $(SRC),$(OBJ),$(mines_server_sources:.cpp=.o))
+mines_server_deps    := $(mines_server_objects:.o=.d)
+
+apps    += $(BIN)/mines_server
+sources += $(mines_server_sources)
+objects += $(mines_server_objects)
+deps    += $(mines_server_deps)
+
+# hosts games with the mines engine, without a terminal
+mines_server_objects += $(OBJ)/mines/bot_protocol.o $(OBJ)/mines/cell_set.o $(OBJ)/mines/game.o $(OBJ)/mines/minesweeper.o $(OBJ)/mines/summary.o
+
+.PHONY: mines_server
+mines_server: $(BIN)/mines_server
@@ -0,0 +1,267 @@
+#include <ngames/mines_server/server.hpp>
+
+#include <ngames/common/unix_socket.hpp>
+
+#include <array>
+#include <string_view>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+// Longest request line accepted. Sessions sending longer lines are closed.
+constexpr size_t MAX_LINE = 64 * 1024;
+
+// Most bytes of replies a session holds before it stops reading requests.
+constexpr size_t MAX_OUTPUT = 1024 * 1024;
+
+// Most events handled per call to `epoll_wait()`.
+constexpr int MAX_EVENTS = 64;
+
+}  // namespace
+
+
+namespace ngames::mines_server
+{
+
+Worker::Worker()
+    : epoll_fd(epoll_create1(EPOLL_CLOEXEC)), event_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), stopping(false)
+{
+    if (!is_open()) {
+        return;
+    }
+    // NOTE: the event fd is told apart from sessions by its null pointer
+    epoll_event event = {.events = EPOLLIN, .data = {.ptr = nullptr}};
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &event) < 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+        return;
+    }
+    thread = std::thread(&Worker::loop, this);
+}
+
+Worker::~Worker()
+{
+    if (thread.joinable()) {
+        stopping = true;
+        const uint64_t one = 1;
+        write(event_fd, &one, sizeof(one));
+        thread.join();
+    }
+    pool.for_each([](Session& session) { close(session.fd); });
+    for (const int fd : incoming) {
+        close(fd);
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+    if (event_fd >= 0) {
+        close(event_fd);
+    }
+}
+
+void Worker::add(int fd)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        incoming.push_back(fd);
+    }
+    const uint64_t one = 1;
+    write(event_fd, &one, sizeof(one));
+}
+
+void Worker::loop()
+{
+    std::array<epoll_event, MAX_EVENTS> events;
+    while (!stopping) {
+        const int num_events = epoll_wait(epoll_fd, events.data(), events.size(), -1);
+        if (num_events < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait");
+            return;
+        }
+
+        for (int i = 0; i < num_events; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t count;
+                read(event_fd, &count, sizeof(count));
+                accept_incoming();
+                continue;
+            }
+
+            Session* session = static_cast<Session*>(events[i].data.ptr);
+            bool ok = true;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                ok = receive(*session);
+            }
+            if (ok && (events[i].events & EPOLLOUT)) {
+                ok = flush(*session);
+            }
+            if (!ok) {
+                close_session(session);
+            }
+        }
+    }
+}
+
+void Worker::accept_incoming()
+{
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fds.swap(incoming);
+    }
+    for (const int fd : fds) {
+        Session* session = pool.create(fd);
+        epoll_event event = {.events = EPOLLIN, .data = {.ptr = session}};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            perror("epoll_ctl");
+            close(fd);
+            pool.destroy(session);
+        }
+    }
+}
+
+bool Worker::receive(Session& session)
+{
+    char chunk[4096];
+    // NOTE: a client that does not read its replies is not read from either,
+    // so that neither buffer grows without bound
+    while (session.output.size() < MAX_OUTPUT) {
+        const ssize_t length = recv(session.fd, chunk, sizeof(chunk), 0);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length <= 0) {
+            return false;
+        }
+        session.input.append(chunk, length);
+        handle_lines(session);
+        // all complete lines were handled unless replies are held back
+        if (session.output.size() < MAX_OUTPUT && session.input.size() > MAX_LINE) {
+            return false;
+        }
+        if (static_cast<size_t>(length) < sizeof(chunk)) {
+            break;
+        }
+    }
+    return flush(session);
+}
+
+void Worker::handle_lines(Session& session)
+{
+    size_t begin = 0;
+    size_t end;
+    while (session.output.size() < MAX_OUTPUT && (end = session.input.find('\n', begin)) != std::string::npos) {
+        session.protocol.handle(std::string_view(session.input).substr(begin, end - begin), reply);
+        session.output += reply;
+        session.output += '\n';
+        begin = end + 1;
+    }
+    session.input.erase(0, begin);
+}
+
+bool Worker::flush(Session& session)
+{
+    size_t sent = 0;
+    while (sent < session.output.size()) {
+        // NOTE: a client that went away must not kill the server with SIGPIPE
+        const ssize_t length =
+            send(session.fd, session.output.data() + sent, session.output.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (length < 0) {
+            return false;
+        }
+        sent += length;
+    }
+    session.output.erase(0, sent);
+    // handle the requests held back while replies were over the cap; their
+    // replies are sent once the socket is writable again
+    handle_lines(session);
+
+    // only wait for the socket to become writable while replies are pending,
+    // and only read requests while they are under the cap
+    const bool writing = !session.output.empty();
+    const bool reading = session.output.size() < MAX_OUTPUT;
+    if (writing != session.writing || reading != session.reading) {
+        epoll_event event = {.events = (reading ? EPOLLIN : 0u) | (writing ? EPOLLOUT : 0u), .data = {.ptr = &session}};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session.fd, &event) < 0) {
+            return false;
+        }
+        session.writing = writing;
+        session.reading = reading;
+    }
+    return true;
+}
+
+void Worker::close_session(Session* session)
+{
+    // NOTE: closing the socket also removes it from the epoll instance
+    close(session->fd);
+    pool.destroy(session);
+}
+
+Server::Server(int num_threads)
+{
+    for (int i = 0; i < num_threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+bool Server::is_open() const
+{
+    for (const auto& worker : workers) {
+        if (!worker->is_open()) {
+            return false;
+        }
+    }
+    return !workers.empty();
+}
+
+int Server::run(const char* path)
+{
+    const int listen_fd = listen_unix(path);
+    if (listen_fd < 0) {
+        return 1;
+    }
+
+    // hand connections to the workers in turn
+    size_t next = 0;
+    while (true) {
+        const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0 && (errno == EINTR || errno == ECONNABORTED)) {
+            continue;
+        }
+        if (fd < 0) {
+            perror("accept");
+            break;
+        }
+        workers[next]->add(fd);
+        next = (next + 1) % workers.size();
+    }
+
+    close(listen_fd);
+    unlink(path);
+    return 1;
+}
+
+}  // namespace ngames::mines_server
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <ngames/mines_server/session_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace ngames::mines_server
+{
+
+/**
+ * Thread serving a share of the sessions, waiting for I/O on all of them at
+ * once with epoll.
+ */
+class Worker
+{
+public:
+    /**
+     * Create epoll instance and start the thread. Check `is_open()` for
+     * success.
+     */
+    Worker();
+
+    /**
+     * Close all sessions and stop the thread.
+     */
+    ~Worker();
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    /**
+     * Returns true if the epoll instance was successfully created.
+     */
+    inline bool is_open() const { return epoll_fd >= 0 && event_fd >= 0; }
+
+    /**
+     * Hand a new connection over to the worker. Thread-safe.
+     * @param fd Socket of the client.
+     */
+    void add(int fd);
+
+private:
+    /**
+     * Body of the thread. Serves sessions until stopped.
+     */
+    void loop();
+
+    /**
+     * Create sessions for the connections handed over by `add()`.
+     */
+    void accept_incoming();
+
+    /**
+     * Read from a session and handle all complete request lines, unless too
+     * many replies are pending.
+     * @param session Session.
+     * @returns False if the session should be closed.
+     */
+    bool receive(Session& session);
+
+    /**
+     * Handle the complete request lines received, until too many replies are
+     * pending.
+     * @param session Session.
+     */
+    void handle_lines(Session& session);
+
+    /**
+     * Send as many pending replies as the socket takes without blocking, and
+     * wait for it to become writable if some are left. Stops reading requests
+     * while too many replies are pending.
+     * @param session Session.
+     * @returns False if the session should be closed.
+     */
+    bool flush(Session& session);
+
+    /**
+     * Close a session and return its memory to the pool.
+     * @param session Session.
+     */
+    void close_session(Session* session);
+
+    int epoll_fd;
+    // Wakes up the thread when connections are handed over, or when stopping.
+    int event_fd;
+
+    // Guards `incoming`.
+    std::mutex mutex;
+    // Connections handed over, but not served yet.
+    std::vector<int> incoming;
+    // Whether the thread should exit.
+    std::atomic<bool> stopping;
+
+    // Only used by the thread.
+    SessionPool pool;
+    // Scratch buffer for replies.
+    std::string reply;
+
+    std::thread thread;
+};
+
+/**
+ * Daemon hosting many independent Minesweeper games for local clients over a
+ * Unix domain socket. Each connection is a session speaking the bot protocol,
+ * see ngames/mines/bot_protocol.hpp. Sessions are spread over a fixed pool of
+ * worker threads.
+ */
+class Server
+{
+public:
+    /**
+     * Create server and start the worker threads. Check `is_open()` for
+     * success.
+     * @param num_threads Number of worker threads.
+     */
+    Server(int num_threads);
+
+    /**
+     * Returns true if all workers were successfully started.
+     */
+    bool is_open() const;
+
+    /**
+     * Listen on a socket and hand connections to the workers until accepting
+     * a connection fails.
+     * @param path Path of the socket. Any existing file is replaced.
+     * @returns Return code. A non-zero value means that an error occurred.
+     */
+    int run(const char* path);
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+}  // namespace ngames::mines_server
@@ -0,0 +1,43 @@
+#include <ngames/mines_server/session_pool.hpp>
+
+#include <cassert>
+
+
+namespace ngames::mines_server
+{
+
+Session::Session(int id, int fd, std::byte* buffer, size_t size)
+    : id(id),
+      fd(fd),
+      arena(buffer, size),
+      // NOTE: one block per chunk keeps the pool close to what the game uses
+      pool(std::pmr::pool_options{.max_blocks_per_chunk = 1, .largest_required_pool_block = LARGEST_POOL_BLOCK},
+           &arena),
+      protocol(true, &pool),
+      input(&pool),
+      output(&pool)
+{
+}
+
+Session* SessionPool::create(int fd)
+{
+    if (free_slots.empty()) {
+        slots.push_back(std::make_unique<Slot>());
+        free_slots.push_back(static_cast<int>(slots.size()) - 1);
+    }
+    const int id = free_slots.back();
+    free_slots.pop_back();
+    Slot& slot = *slots[id];
+    return &slot.session.emplace(id, fd, slot.buffer, ARENA_SIZE);
+}
+
+void SessionPool::destroy(Session* session)
+{
+    const int id = session->id;
+    assert(slots[id]->session.has_value() && &*slots[id]->session == session);  // session must belong to this pool
+
+    slots[id]->session.reset();
+    free_slots.push_back(id);
+}
+
+}  // namespace ngames::mines_server
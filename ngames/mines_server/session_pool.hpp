@@ -0,0 +1,116 @@
+#pragma once
+
+#include <ngames/mines/bot_protocol.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace ngames::mines_server
+{
+
+/**
+ * Connection of a client, playing one game at a time through the bot
+ * protocol, see ngames/mines/bot_protocol.hpp.
+ */
+struct Session {
+    // Largest block served by the pool, the most the standard library allows.
+    static constexpr size_t LARGEST_POOL_BLOCK = 4 * 1024 * 1024;
+
+    /**
+     * Create session whose allocations come from its own pool.
+     * @param id Index of the session in its pool.
+     * @param fd Socket of the client.
+     * @param buffer Initial buffer of the arena.
+     * @param size Size of the initial buffer.
+     */
+    Session(int id, int fd, std::byte* buffer, size_t size);
+
+    // Index of the session in its pool.
+    const int id;
+    // Socket of the client.
+    const int fd;
+    // Serves the initial buffer, then the heap, to `pool`. Never reuses the
+    // memory freed, which `pool` does.
+    std::pmr::monotonic_buffer_resource arena;
+    // Holds the game and the buffers below, reusing the memory they free, so
+    // that a session playing game after game stays the same size. Blocks
+    // larger than the largest pool block, i.e. boards of millions of cells,
+    // come from `arena`, and are only reallocated when the board size changes.
+    std::pmr::unsynchronized_pool_resource pool;
+    ngames::mines::BotProtocol protocol;
+    // Received data not handled yet, i.e. an incomplete line, or lines held
+    // back while too many replies are pending.
+    std::pmr::string input;
+    // Replies not sent yet.
+    std::pmr::string output;
+    // Whether we wait for the socket to become writable.
+    bool writing = false;
+    // Whether we wait for the socket to become readable.
+    bool reading = true;
+};
+
+/**
+ * Pool of sessions, each with its own memory pool. Creating and destroying a
+ * session takes constant time, and the memory of a destroyed session is
+ * reused by the next one created, so sessions coming and going do not
+ * fragment the heap. Not thread-safe.
+ */
+class SessionPool
+{
+public:
+    // Size of the initial buffer of each arena. A 16x30 expert game, with its
+    // pool bookkeeping, takes under 40 KiB.
+    static constexpr size_t ARENA_SIZE = 64 * 1024;
+
+    /**
+     * Create session.
+     * @param fd Socket of the client.
+     */
+    Session* create(int fd);
+
+    /**
+     * Destroy session, returning its memory to the pool.
+     * @param session Session created by this pool.
+     */
+    void destroy(Session* session);
+
+    /**
+     * Return number of sessions alive.
+     */
+    inline int size() const { return static_cast<int>(slots.size() - free_slots.size()); }
+
+    /**
+     * Call a function on each session alive.
+     * @param f Function taking a `Session&`.
+     */
+    template <typename F>
+    void for_each(F f)
+    {
+        for (auto& slot : slots) {
+            if (slot->session.has_value()) {
+                f(*slot->session);
+            }
+        }
+    }
+
+private:
+    /**
+     * Memory for a session and its arena.
+     */
+    struct Slot {
+        alignas(std::max_align_t) std::byte buffer[ARENA_SIZE];
+        std::optional<Session> session;
+    };
+
+    // All slots ever allocated; only grows when all slots are in use.
+    std::vector<std::unique_ptr<Slot>> slots;
+    // Indices of the slots not in use.
+    std::vector<int> free_slots;
+};
+
+}  // namespace ngames::mines_server
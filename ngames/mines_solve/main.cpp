@@ -0,0 +1,229 @@
+#include <ngames/mines/game.hpp>
+#include <ngames/mines/minesweeper.hpp>
+#include <ngames/mines/solver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  mines_solve [options]\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Analyzes seeded positions with the mines solver, once per number of threads from 1 up to -j,\n");
+    fprintf(stderr, "doubling each time, and reports the time per position. Fails if the analyses differ.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -b <r> <c> <m>         board size (default 1000 1000 150000)\n");
+    fprintf(stderr, "  -n <positions>         positions to analyze (default 4)\n");
+    fprintf(stderr, "  -o <opens>             safe cells opened at random in each position (default 3000)\n");
+    fprintf(stderr, "  -s <seed>              seed of the first position (default 1)\n");
+    fprintf(stderr, "  -j <threads>           most threads (default number of cores)\n");
+    fprintf(stderr, "  -c <entries>           cache component enumerations across positions and runs (default off)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    int rows = 1000;
+    int cols = 1000;
+    int mines = 150000;
+    // Number of positions to analyze.
+    int positions = 4;
+    // Number of safe cells opened in each position.
+    int opens = 3000;
+    // Position `i` is played with seed `seed + i`.
+    unsigned seed = 1;
+    // Most threads to analyze with.
+    int threads;
+    // Entries of the cache of component enumerations, or zero for none.
+    int cache = 0;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+    args.threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h") {
+            help_and_exit();
+        }
+        const int num_values = arg == "-b" ? 3 : 1;
+        if (i + num_values >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-b") {
+            args.rows = str_to_int(argv[++i]);
+            args.cols = str_to_int(argv[++i]);
+            args.mines = str_to_int(argv[++i]);
+        } else if (arg == "-n") {
+            args.positions = str_to_int(argv[++i]);
+        } else if (arg == "-o") {
+            args.opens = str_to_int(argv[++i]);
+        } else if (arg == "-s") {
+            args.seed = str_to_int(argv[++i]);
+        } else if (arg == "-j") {
+            args.threads = str_to_int(argv[++i]);
+        } else if (arg == "-c") {
+            args.cache = str_to_int(argv[++i]);
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        }
+    }
+
+    if (args.rows < 1 || args.cols < 1 || args.mines < 0 || static_cast<int64_t>(args.rows) * args.cols > INT_MAX ||
+        args.mines > args.rows * args.cols - 1) {
+        fprintf(stderr, "Invalid board size: %d %d %d\n", args.rows, args.cols, args.mines);
+        help_and_exit();
+    }
+    if (args.positions < 1 || args.opens < 0 || args.threads < 1 || args.cache < 0) {
+        fprintf(stderr, "Positions and threads must be positive.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+/**
+ * Play a position by clicking the center, and then random safe cells.
+ * @param args Arguments.
+ * @param seed Seed of the game.
+ * @param game Game to play.
+ */
+static void play_position(const Args& args, unsigned seed, ngames::mines::Game& game)
+{
+    const int first_row = args.rows / 2;
+    const int first_col = args.cols / 2;
+    const std::vector<bool> is_mine =
+        ngames::mines::Minesweeper::layout(args.rows, args.cols, args.mines, seed, first_row, first_col);
+    game.reset(seed);
+    game.click_cell(first_row, first_col);
+
+    std::mt19937 rng(seed);
+    for (int open = 0; open < args.opens && game.get_state() == ngames::mines::Game::active;) {
+        const int idx = rng() % (args.rows * args.cols);
+        if (!is_mine[idx] && !game.is_opened(idx / args.cols, idx % args.cols)) {
+            game.click_cell(idx / args.cols, idx % args.cols);
+            ++open;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+
+    std::vector<ngames::mines::Game> games;
+    for (int i = 0; i < args.positions; ++i) {
+        games.emplace_back(args.rows, args.cols, args.mines);
+        play_position(args, args.seed + i, games.back());
+    }
+
+    // NOTE: the cache is shared by all runs, so later runs mostly hit
+    std::optional<ngames::mines::Solver::Cache> cache;
+    if (args.cache > 0) {
+        cache.emplace(args.cache);
+    }
+
+    std::vector<ngames::mines::Analysis> expected(args.positions);
+    double base_ms = 0;
+    for (int threads = 1; threads <= args.threads;
+         threads = threads < args.threads ? std::min(threads * 2, args.threads) : threads + 1) {
+        ngames::mines::Solver solver(threads, cache.has_value() ? &*cache : nullptr);
+        ngames::mines::Analysis analysis;
+        // warm up, so that first-touch page faults are not timed
+        solver.analyze(games[0], analysis);
+        const ngames::mines::CacheStats cache_start = cache.has_value() ? cache->get_stats() : ngames::mines::CacheStats();
+        long components = 0;
+        long estimated = 0;
+        bool identical = true;
+        double elapsed_ms = 0;
+        for (int i = 0; i < args.positions; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            solver.analyze(games[i], analysis);
+            elapsed_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            components += analysis.num_components;
+            estimated += analysis.num_estimated;
+            if (threads == 1) {
+                expected[i] = analysis;
+            } else {
+                identical = identical && analysis.probabilities == expected[i].probabilities &&
+                            analysis.safe_cells == expected[i].safe_cells &&
+                            analysis.mine_cells == expected[i].mine_cells;
+            }
+        }
+        const double ms = elapsed_ms / args.positions;
+        if (threads == 1) {
+            base_ms = ms;
+        }
+        printf("threads=%d positions=%d components=%ld estimated=%ld ms_per_position=%.2f speedup=%.2f identical=%d",
+               threads,
+               args.positions,
+               components / args.positions,
+               estimated / args.positions,
+               ms,
+               base_ms / ms,
+               identical);
+        if (cache.has_value()) {
+            const ngames::mines::CacheStats stats = cache->get_stats();
+            const uint64_t lookups = stats.lookups - cache_start.lookups;
+            const uint64_t hits = stats.hits - cache_start.hits;
+            printf(" cache_hit_rate=%.3f cache_evictions=%lu",
+                   lookups > 0 ? static_cast<double>(hits) / lookups : 0.0,
+                   static_cast<unsigned long>(stats.evictions - cache_start.evictions));
+        }
+        printf("\n");
+        if (!identical) {
+            fprintf(stderr, "Analysis with %d threads differs from the analysis with 1 thread.\n", threads);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
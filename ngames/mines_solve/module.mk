@@ -0,0 +1,14 @@
+mines_solve_sources := $(wildcard $(SRC)/mines_solve/*.cpp)
+mines_solve_objects := $(subst $(SRC),$(OBJ),$(mines_solve_sources:.cpp=.o))
+mines_solve_deps    := $(mines_solve_objects:.o=.d)
+
+apps    += $(BIN)/mines_solve
+sources += $(mines_solve_sources)
+objects += $(mines_solve_objects)
+deps    += $(mines_solve_deps)
+
+# analyzes positions with the mines engine, without a terminal
+mines_solve_objects += $(OBJ)/mines/cell_set.o $(OBJ)/mines/game.o $(OBJ)/mines/minesweeper.o $(OBJ)/mines/solver.o $(OBJ)/mines/summary.o
+
+.PHONY: mines_solve
+mines_solve: $(BIN)/mines_solve
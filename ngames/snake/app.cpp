@@ -25,7 +25,9 @@ App::App(int rows, int cols, int frames_per_tick, double frames_per_sec)
       text_score(board, MARGIN_TOP, MARGIN_LEFT),
       board_border(rows, cols, text_score.bottom(), MARGIN_LEFT),
       board(rows, cols, board_border.inner_start_y(), board_border.inner_start_x(), board_border.window),
-      text_instructions(board_border.bottom() + 1, MARGIN_LEFT)
+      text_instructions(board_border.bottom() + 1, MARGIN_LEFT),
+      autopilot(rows, cols),
+      autopilot_active(false)
 {
     init_colors();
     curs_set(0);                  // hide cursor
@@ -62,6 +64,9 @@ void App::run()
         switch (signal) {
             case Signal::reset:
                 board.reset();
+                if (autopilot_active && autopilot.reset(board.get_snake()) != 0) {
+                    autopilot_active = false;
+                }
                 // restart tick
                 iframe = 0;
                 break;
@@ -71,7 +76,10 @@ void App::run()
                 break;
             case Signal::none:
                 // proceed as normal
-                if (iframe % frames_per_tick == 0) {
+                if (autopilot_active) {
+                    board.set_snake_direction(autopilot.next_direction(board.get_snake(), board.get_apple()));
+                    board.tick();
+                } else if (iframe % frames_per_tick == 0) {
                     board.tick();
                 }
                 break;
@@ -94,25 +102,29 @@ App::Signal App::handle_keystroke(int key)
     switch (key) {
         case 'h':
         case KEY_LEFT:
-            board.set_snake_direction(Direction::left);
+            steer(Direction::left);
             break;
         case 'j':
         case KEY_DOWN:
-            board.set_snake_direction(Direction::down);
+            steer(Direction::down);
             break;
         case 'k':
         case KEY_UP:
-            board.set_snake_direction(Direction::up);
+            steer(Direction::up);
             break;
         case 'l':
         case KEY_RIGHT:
-            board.set_snake_direction(Direction::right);
+            steer(Direction::right);
             break;
+        case 'a':  // autopilot, which starts a new game
+            autopilot_active = !autopilot_active;
+            return autopilot_active ? Signal::reset : Signal::none;
         case 'z':  // new game
             board.reset();
             return Signal::reset;
         case 'r':  // refresh
             clearok(curscr, true);
+            board.redraw();
             break;
         case 'q':  // quit
             return Signal::quit;
@@ -120,4 +132,10 @@ App::Signal App::handle_keystroke(int key)
     return Signal::none;
 }
 
+void App::steer(Direction dir)
+{
+    autopilot_active = false;
+    board.set_snake_direction(dir);
+}
+
 }  // namespace ngames::snake
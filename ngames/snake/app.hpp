@@ -1,6 +1,8 @@
 #pragma once
 
+#include <ngames/snake/autopilot.hpp>
 #include <ngames/snake/board.hpp>
+#include <ngames/snake/direction.hpp>
 #include <ngames/snake/text_instructions.hpp>
 #include <ngames/snake/text_score.hpp>
 
@@ -53,6 +55,13 @@ private:
      */
     Signal handle_keystroke(int key);
 
+    /**
+     * Set the snake direction as asked by the player, who takes over from the
+     * autopilot.
+     * @param dir Desired direction.
+     */
+    void steer(Direction dir);
+
     int frames_per_tick;
     double frames_per_sec;
 
@@ -60,6 +69,10 @@ private:
     Border board_border;
     Board board;
     TextInstructions text_instructions;
+
+    Autopilot autopilot;
+    // Whether the autopilot plays, one tick per frame.
+    bool autopilot_active;
 };
 
 }  // namespace ngames::snake
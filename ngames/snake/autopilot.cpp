@@ -0,0 +1,233 @@
+#include <ngames/snake/autopilot.hpp>
+
+#include <climits>
+#include <tuple>
+
+#include <cassert>
+
+
+namespace ngames::snake
+{
+
+Autopilot::Autopilot(int rows, int cols)
+    : rows(rows),
+      cols(cols),
+      slots(rows * cols),
+      num_slots(0),
+      distances(rows * cols),
+      generations(rows * cols, 0),
+      generation(0),
+      queue_head(0)
+{
+    assert(rows >= 2);
+    assert(cols >= 2);
+
+    queue.reserve(rows * cols);
+}
+
+int Autopilot::reset(const Snake& snake)
+{
+    distances_apple.reset();
+    lap_apple.reset();
+    for (const bool transpose : {false, true}) {
+        for (const bool mirror : {false, true}) {
+            if (build_cycle(transpose, mirror) && follows_cycle(snake)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+Direction Autopilot::next_direction(const Snake& snake, const std::optional<std::pair<int, int>>& apple)
+{
+    if (apple.has_value()) {
+        if (apple != distances_apple) {
+            start_distances(*apple);
+        }
+        expand_distances(BFS_CELLS_PER_MOVE);
+    }
+
+    const auto [head_row, head_col] = snake.chain.front();
+    const int head = head_row * cols + head_col;
+    const auto [tail_row, tail_col] = snake.chain.back();
+    const int tail = tail_row * cols + tail_col;
+    // slots free of the snake ahead of the head, plus the tail's
+    const int room = snake.chain.size() > 1 ? slots_between(head, tail) : num_slots;
+    // the last free cell can be eaten whatever its slot, which wins the game
+    const bool last_cell = snake.chain.size() + 1 == rows * cols;
+    // slots until the apple. When the head shares the apple's slot, it goes a
+    // whole lap along the cycle without shortcuts, which would leave cells for
+    // the tail to skip: the tail could then share the apple's slot again, and
+    // block the apple, when the head is back next to it
+    int apple_ahead = num_slots;
+    if (apple.has_value()) {
+        const int ahead = slots_between(head, apple->first * cols + apple->second);
+        if (ahead > 0) {
+            apple_ahead = ahead;
+        } else {
+            lap_apple = apple;
+        }
+    }
+    const bool shortcuts = apple != lap_apple;
+
+    Direction best_dir = snake.direction;
+    bool best_overshoots = true;
+    int best_distance = INT_MAX;
+    int best_ahead = INT_MAX;
+    for (const Direction dir : {Direction::up, Direction::down, Direction::left, Direction::right}) {
+        const auto cell = snake.next_head(&dir);
+        const auto [row, col] = cell;
+        if (row < 0 || row >= rows || col < 0 || col >= cols) {
+            continue;
+        }
+        // the snake cannot turn back onto itself
+        if (snake.chain.size() > 1 && cell == snake.chain[1]) {
+            continue;
+        }
+        const int next = row * cols + col;
+        const int ahead = slots_between(head, next);
+        const bool safe = (ahead > 0 && ahead < room) || next == tail || (last_cell && cell == apple);
+        if (!safe) {
+            continue;
+        }
+        // a move past the apple along the cycle would take a whole lap to
+        // come back to it, so moves stop at the apple, which is then reached
+        // within a lap
+        const bool overshoots = ahead > apple_ahead;
+        // then fewest moves to the apple, unless going a lap, then skipping
+        // fewest cells. cells the BFS has not reached yet are further from the
+        // apple than those it has
+        int distance = generations[next] == generation ? distances[next] : INT_MAX;
+        if (!shortcuts && cell != apple) {
+            distance = INT_MAX;
+        }
+        if (std::tie(overshoots, distance, ahead) < std::tie(best_overshoots, best_distance, best_ahead)) {
+            best_dir = dir;
+            best_overshoots = overshoots;
+            best_distance = distance;
+            best_ahead = ahead;
+        }
+    }
+    return best_dir;
+}
+
+bool Autopilot::build_cycle(bool transpose, bool mirror)
+{
+    // the cycle is built on a board of `num_rows` by `num_cols`, then
+    // transposed if needed
+    const int num_rows = transpose ? cols : rows;
+    const int num_cols = transpose ? rows : cols;
+    // every cycle of a grid has an even length, so with an odd number of
+    // rows there must be an odd number of columns to leave out a cell
+    if (num_rows % 2 != 0 && num_cols % 2 == 0) {
+        return false;
+    }
+
+    int slot = 0;
+    const auto idx = [&](int row, int col) {
+        if (mirror) {
+            col = num_cols - 1 - col;
+        }
+        return transpose ? col * cols + row : row * cols + col;
+    };
+    const auto visit = [&](int row, int col) { slots[idx(row, col)] = slot++; };
+
+    // right along the first row
+    for (int col = 0; col < num_cols; ++col) {
+        visit(0, col);
+    }
+    // then back and forth through the other columns, leaving the last two
+    // rows for an odd number of rows
+    const int last_row = num_rows % 2 == 0 ? num_rows - 1 : num_rows - 3;
+    for (int row = 1; row <= last_row; ++row) {
+        for (int i = 1; i < num_cols; ++i) {
+            visit(row, row % 2 != 0 ? num_cols - i : i);
+        }
+    }
+    if (num_rows % 2 != 0) {
+        // down the last column to the corner's neighbor, then through the
+        // corner's diagonal neighbor, whose slot the corner shares, to the
+        // corner's other neighbor
+        visit(num_rows - 2, num_cols - 1);
+        visit(num_rows - 2, num_cols - 2);
+        slots[idx(num_rows - 1, num_cols - 1)] = slot - 1;
+        visit(num_rows - 1, num_cols - 2);
+        // then up and down through the last two rows
+        for (int col = num_cols - 3; col > 0; --col) {
+            const bool up = (num_cols - 3 - col) % 2 == 0;
+            visit(up ? num_rows - 1 : num_rows - 2, col);
+            visit(up ? num_rows - 2 : num_rows - 1, col);
+        }
+    }
+    // and up the first column
+    for (int row = num_rows - 1; row > 0; --row) {
+        visit(row, 0);
+    }
+    num_slots = slot;
+    return true;
+}
+
+bool Autopilot::follows_cycle(const Snake& snake) const
+{
+    // add up the slots between each cell and the next, from tail to head
+    int total = 0;
+    for (int i = snake.chain.size() - 1; i > 0; --i) {
+        const auto [row, col] = snake.chain[i];
+        const auto [next_row, next_col] = snake.chain[i - 1];
+        const int ahead = slots_between(row * cols + col, next_row * cols + next_col);
+        if (ahead == 0) {
+            return false;
+        }
+        total += ahead;
+    }
+    return total < num_slots;
+}
+
+void Autopilot::start_distances(const std::pair<int, int>& apple)
+{
+    // NOTE: bumping the generation forgets every distance at once
+    ++generation;
+    const auto [apple_row, apple_col] = apple;
+    distances[apple_row * cols + apple_col] = 0;
+    generations[apple_row * cols + apple_col] = generation;
+    queue.clear();
+    queue.push_back(apple);
+    queue_head = 0;
+    distances_apple = apple;
+}
+
+void Autopilot::expand_distances(int max_cells)
+{
+    const auto [apple_row, apple_col] = *distances_apple;
+    const int target = apple_row * cols + apple_col;
+    // BFS backwards from the apple, along moves that get closer to it along
+    // the cycle
+    for (; max_cells > 0 && queue_head < queue.size(); --max_cells) {
+        const auto [row, col] = queue[queue_head++];
+        const int idx = row * cols + col;
+        const int remaining = slots_between(idx, target);
+        const auto visit = [&](int prev_row, int prev_col) {
+            const int prev = prev_row * cols + prev_col;
+            if (generations[prev] != generation && slots_between(prev, target) > remaining) {
+                distances[prev] = distances[idx] + 1;
+                generations[prev] = generation;
+                queue.emplace_back(prev_row, prev_col);
+            }
+        };
+        if (row > 0) {
+            visit(row - 1, col);
+        }
+        if (row < rows - 1) {
+            visit(row + 1, col);
+        }
+        if (col > 0) {
+            visit(row, col - 1);
+        }
+        if (col < cols - 1) {
+            visit(row, col + 1);
+        }
+    }
+}
+
+}  // namespace ngames::snake
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <ngames/snake/direction.hpp>
+#include <ngames/snake/snake.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::snake
+{
+
+/**
+ * Plays Snake by itself, never colliding.
+ *
+ * The snake follows a Hamiltonian cycle of the board, precomputed once: each
+ * cell has a slot, its position along the cycle. As long as the slots of the
+ * snake body increase from tail to head, moving the head to any cell whose
+ * slot lies between the head and the tail is safe, since following the cycle
+ * from there never reaches the body before the tail has moved away. The
+ * autopilot takes such shortcuts toward the apple, but never past it along the
+ * cycle, so it reaches the apple within a lap. It picks the move with the
+ * fewest moves left to the apple, as read from a BFS distance field over the
+ * moves that get closer to the apple along the cycle. The field does not
+ * depend on the snake, so it is only restarted when the apple moves, and the
+ * BFS then visits a bounded number of cells per move, so each move takes a
+ * few microseconds however large the board. Until the BFS reaches the cells
+ * next to the head, the snake follows the cycle.
+ *
+ * A board whose sides are both odd has no Hamiltonian cycle, so a corner is
+ * left out of the cycle and shares the slot of its diagonal neighbor, which
+ * the cycle visits between the corner's two neighbors.
+ */
+class Autopilot
+{
+public:
+    // Most cells the BFS of the distance field visits per move. The field of
+    // a 200x200 board is then complete after 40 moves.
+    static constexpr int BFS_CELLS_PER_MOVE = 1024;
+
+    /**
+     * Create autopilot for a board.
+     * @param rows Number of rows, at least 2.
+     * @param cols Number of columns, at least 2.
+     */
+    Autopilot(int rows, int cols);
+
+    /**
+     * Start playing a new snake, choosing a cycle along which its slots
+     * increase from tail to head.
+     *
+     * @param snake Snake.
+     *
+     * @returns Return code. A non-zero value means that an error occurred, and
+     * the autopilot cannot play this snake. The possible error codes are
+     *   1: no cycle passes through the snake body in order.
+     */
+    int reset(const Snake& snake);
+
+    /**
+     * Choose the direction of the next move. Takes constant time.
+     * @param snake Snake, which must have only moved as directed since
+     * `reset()`.
+     * @param apple Apple location (row, cell), if any.
+     */
+    Direction next_direction(const Snake& snake, const std::optional<std::pair<int, int>>& apple);
+
+    const int rows;
+    const int cols;
+
+private:
+    /**
+     * Compute the slot of every cell along a cycle of the board, built row by
+     * row, then transformed.
+     * @param transpose If true, the cycle is built column by column instead.
+     * @param mirror If true, the cycle is mirrored left to right, or top to
+     * bottom when transposed.
+     * @returns Whether such a cycle exists for the board.
+     */
+    bool build_cycle(bool transpose, bool mirror);
+
+    /**
+     * Returns `true` if the slots of a snake body increase from tail to head,
+     * wrapping around less than once.
+     */
+    bool follows_cycle(const Snake& snake) const;
+
+    /**
+     * Returns how many slots lie ahead of a cell along the cycle until another.
+     * @param from Cell index.
+     * @param to Cell index.
+     */
+    inline int slots_between(int from, int to) const
+    {
+        const int diff = slots[to] - slots[from];
+        return diff < 0 ? diff + num_slots : diff;
+    }
+
+    /**
+     * Forget the distance field, and start a BFS of the number of moves from
+     * every cell to the apple, each getting closer to the apple along the
+     * cycle. Takes constant time.
+     * @param apple Apple location (row, cell).
+     */
+    void start_distances(const std::pair<int, int>& apple);
+
+    /**
+     * Continue the BFS of the distance field, if not complete.
+     * @param max_cells Most cells to visit.
+     */
+    void expand_distances(int max_cells);
+
+    // NOTE: we encode the pair (row, col) as a single index: row * cols + col
+    // Slot of each cell along the cycle.
+    std::vector<int> slots;
+    // Number of slots of the cycle.
+    int num_slots;
+    // Number of moves from each cell to the apple, for the cells reached by
+    // the BFS so far.
+    std::vector<int> distances;
+    // Generation of the BFS that reached each cell. Cells of an older
+    // generation have not been reached yet.
+    std::vector<uint32_t> generations;
+    // Generation of the current BFS.
+    uint32_t generation;
+    // Apple location `distances` are computed for.
+    std::optional<std::pair<int, int>> distances_apple;
+    // Apple whose slot the head shared, which it then goes to along the cycle.
+    std::optional<std::pair<int, int>> lap_apple;
+    // Queue of cells (row, col) of the BFS, kept to avoid allocating.
+    std::vector<std::pair<int, int>> queue;
+    // Position in `queue` of the next cell to visit.
+    size_t queue_head;
+};
+
+}  // namespace ngames::snake
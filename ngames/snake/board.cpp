@@ -2,11 +2,7 @@
 
 #include <ngames/snake/ui.hpp>
 
-#include <vector>
-
 #include <cassert>
-#include <cstdlib>
-#include <ctime>
 
 
 namespace
@@ -35,7 +31,10 @@ namespace ngames::snake
 Board::Board(int rows, int cols, int start_y, int start_x, WINDOW* border_window)
     : Component(subwin(border_window, rows, cols, start_y, start_x)),
       rows(rows),
-      cols(cols)
+      cols(cols),
+      free_cells(rows, cols),
+      rng(std::random_device()()),
+      needs_redraw(true)
 {
     assert(rows >= MIN_ROWS);
     assert(cols >= MIN_COLS);
@@ -48,12 +47,10 @@ void Board::reset()
     // snake starts at center top
     constexpr int snake_head_row = INIT_SNAKE_LENGTH - 1;
     const int snake_head_col = (cols - 1) / 2;
-    snake = Snake(snake_head_row, snake_head_col, Direction::down, INIT_SNAKE_LENGTH);
-
-    // check snake is inside board
-    for (const auto& [row, col] : snake->chain) {
-        assert(0 <= row && row < rows);
-        assert(0 <= col && col < cols);
+    snake = Snake(rows, cols, snake_head_row, snake_head_col, Direction::down, INIT_SNAKE_LENGTH);
+    free_cells.fill();
+    for (const auto& cell : snake->chain) {
+        free_cells.erase(cell);
     }
 
     // initialize apple at random location
@@ -61,20 +58,36 @@ void Board::reset()
 
     state = State::active;
     score = 0;
+
+    needs_redraw = true;
+    changed_cells.clear();
 }
 
 void Board::refresh() const
 {
-    werase(window);
-    // if game lost, make snake head flash red
-    constexpr auto lose_head_attr = A_BLINK | COLOR_PAIR(COLOR_PAIR_COLLISION);
-    snake->draw(window, state == State::lose ? lose_head_attr : 0);
-    if (apple.has_value()) {
-        draw_apple(window, *apple);
+    if (needs_redraw) {
+        werase(window);
+        // if game lost, make snake head flash red
+        constexpr auto lose_head_attr = A_BLINK | COLOR_PAIR(COLOR_PAIR_COLLISION);
+        snake->draw(window, state == State::lose ? lose_head_attr : 0);
+        if (apple.has_value()) {
+            draw_apple(window, *apple);
+        }
+    } else {
+        for (const auto& cell : changed_cells) {
+            print_cell(cell);
+        }
     }
+    needs_redraw = false;
+    changed_cells.clear();
     wnoutrefresh(window);
 }
 
+void Board::redraw()
+{
+    needs_redraw = true;
+}
+
 void Board::tick()
 {
     if (state != State::active) {
@@ -83,14 +96,26 @@ void Board::tick()
     // if collision, player has lost
     if (check_collision()) {
         state = State::lose;
+        mark_changed(snake->chain.front());
         return;
     }
     // otherwise, move the snake forwards
     const bool grow_snake = apple.has_value() && snake->next_head() == *apple;
+    // the tail leaves before the head enters, which may be the same cell
+    mark_changed(snake->chain.front());
+    if (!grow_snake) {
+        free_cells.insert(snake->chain.back());
+        mark_changed(snake->chain.back());
+    }
     snake->step(grow_snake);
+    free_cells.erase(snake->chain.front());
+    mark_changed(snake->chain.front());
     if (grow_snake) {
         ++score;
         apple = find_unoccupied();
+        if (apple.has_value()) {
+            mark_changed(*apple);
+        }
     }
     // if no possible apple location, then player has won
     if (!apple.has_value()) {
@@ -106,43 +131,14 @@ int Board::set_snake_direction(Direction dir)
         return 2;
     }
     snake->direction = dir;
+    // the head points the new way
+    mark_changed(snake->chain.front());
     return 0;
 }
 
-std::optional<std::pair<int, int>> Board::find_unoccupied() const
+std::optional<std::pair<int, int>> Board::find_unoccupied()
 {
-    // seed RNG with current time
-    std::srand(clock());
-
-    // create list tracking empty cells
-    // NOTE: we encode the pair (row, col) as a single index: row * num_cols + col
-    std::vector<bool> empty(rows * cols, true);
-
-    // mark cells in the snake as `false`
-    for (const auto& [row, col] : snake->chain) {
-        const int idx = row * cols + col;
-        empty[idx] = false;
-    }
-
-    // gather a list of empty indices
-    std::vector<int> empty_idxs;
-    for (int idx = 0; idx < static_cast<int>(empty.size()); ++idx) {
-        if (empty[idx]) {
-            empty_idxs.push_back(idx);
-        }
-    }
-
-    if (empty_idxs.empty()) {
-        return std::nullopt;
-    }
-
-    // draw random index
-    const int idx_idx = std::rand() % empty_idxs.size();
-    const int idx = empty_idxs[idx_idx];
-    const int row = idx / cols;
-    const int col = idx % cols;
-
-    return std::make_pair(row, col);
+    return free_cells.sample(rng);
 }
 
 bool Board::check_collision() const
@@ -154,12 +150,40 @@ bool Board::check_collision() const
     }
     // check collision with itself.
     // we exclude the snake tail since it will move away in time.
-    for (auto it = snake->chain.begin(); it != snake->chain.end() - 1; ++it) {
-        if (next_head == *it) {
-            return true;
-        }
+    return snake->hits_itself(next_head);
+}
+
+void Board::print_cell(const std::pair<int, int>& cell) const
+{
+    const auto [row, col] = cell;
+    if (cell == snake->chain.front()) {
+        // if game lost, make snake head flash red
+        constexpr auto lose_head_attr = A_BLINK | COLOR_PAIR(COLOR_PAIR_COLLISION);
+        const attr_t attr = state == State::lose ? lose_head_attr : 0;
+        wattron(window, attr);
+        mvwaddch(window, row, col, snake->head_char());
+        wattroff(window, attr);
+    } else if (snake->occupies(row, col)) {
+        mvwaddch(window, row, col, '@');
+    } else if (apple == cell) {
+        draw_apple(window, cell);
+    } else {
+        mvwaddch(window, row, col, ' ');
+    }
+}
+
+void Board::mark_changed(const std::pair<int, int>& cell)
+{
+    if (needs_redraw) {
+        return;
+    }
+    // past one change per cell, redrawing the whole board is cheaper
+    if (changed_cells.size() >= static_cast<size_t>(rows) * cols) {
+        needs_redraw = true;
+        changed_cells.clear();
+        return;
     }
-    return false;
+    changed_cells.push_back(cell);
 }
 
 }  // namespace ngames::snake
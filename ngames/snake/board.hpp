@@ -1,11 +1,15 @@
 #pragma once
 
 #include <ngames/snake/direction.hpp>
+#include <ngames/snake/free_cells.hpp>
 #include <ngames/snake/snake.hpp>
 
 #include <ngames/common/component.hpp>
 
 #include <optional>
+#include <random>
+#include <utility>
+#include <vector>
 
 
 namespace ngames::snake
@@ -14,6 +18,11 @@ namespace ngames::snake
 /**
  * Front-end for the Snake game. Manages game state and window viewed by the
  * player.
+ *
+ * Only the cells that changed since the last refresh are redrawn: each tick
+ * changes the old head, the new head, the vacated tail and the apple, so a
+ * frame takes the same time however long the snake is. The whole board is
+ * redrawn after a reset, or when asked with `redraw()`.
  */
 class Board : public Component
 {
@@ -45,6 +54,11 @@ public:
      */
     void refresh() const override;
 
+    /**
+     * Redraw the whole board on the next refresh.
+     */
+    void redraw();
+
     /**
      * Update the state of the board by stepping the snake forward one cell.
      */
@@ -69,16 +83,24 @@ public:
 
     inline int get_score() const { return score; }
 
+    inline const Snake& get_snake() const { return *snake; }
+
+    /**
+     * Returns apple location (row, cell), or null if there is none.
+     */
+    inline const std::optional<std::pair<int, int>>& get_apple() const { return apple; }
+
     const int rows;
     const int cols;
 
 private:
     /**
      * Finds a random cell on the board that is not occupied by the snake. Used
-     * for finding new locations for the apple after it has been eaten.
+     * for finding new locations for the apple after it has been eaten. Takes
+     * constant time.
      * @returns (row, col) of unoccupied cell, or null if all cells are occupied.
      */
-    std::optional<std::pair<int, int>> find_unoccupied() const;
+    std::optional<std::pair<int, int>> find_unoccupied();
 
     /**
      * Returns `true` if the snake's future position will collide into itself
@@ -86,15 +108,39 @@ private:
      */
     bool check_collision() const;
 
+    /**
+     * Print a cell as it currently is: the snake head, its body, the apple,
+     * or empty.
+     * @param cell Cell (row, col).
+     */
+    void print_cell(const std::pair<int, int>& cell) const;
+
+    /**
+     * Mark a cell to be printed on the next refresh.
+     * @param cell Cell (row, col).
+     */
+    void mark_changed(const std::pair<int, int>& cell);
+
     // Snake instance.
     std::optional<Snake> snake;
     // Apple location (row, cell) on the board.
     std::optional<std::pair<int, int>> apple;
+    // Cells not occupied by the snake, kept in sync as it steps.
+    FreeCells free_cells;
+    // RNG for apple locations.
+    std::mt19937 rng;
 
     // Whether the game is active.
     State state;
     // Player score.
     int score;
+
+    // What changed since the window was last drawn, so that only that is
+    // redrawn.
+    // Whether the whole board must be redrawn.
+    mutable bool needs_redraw;
+    // Cells that changed.
+    mutable std::vector<std::pair<int, int>> changed_cells;
 };
 
 }  // namespace ngames::snake
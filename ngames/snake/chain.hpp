@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+
+
+namespace ngames::snake
+{
+
+/**
+ * Cells (row, col) of a snake body from head to tail, in a ring buffer
+ * allocated once for the most cells the snake can have, e.g. every cell of
+ * the board. Adding a head and removing the tail take constant time and never
+ * allocate, and the cells are laid out in at most two contiguous spans.
+ */
+class Chain
+{
+public:
+    using Cell = std::pair<int, int>;
+
+    /**
+     * Iterator over the cells from head to tail.
+     */
+    class Iterator
+    {
+    public:
+        inline Iterator(const Chain& chain, int i) : chain(&chain), i(i) {}
+
+        inline const Cell& operator*() const { return (*chain)[i]; }
+
+        inline Iterator& operator++()
+        {
+            ++i;
+            return *this;
+        }
+
+        inline bool operator==(const Iterator& other) const { return i == other.i; }
+
+    private:
+        const Chain* chain;
+        int i;
+    };
+
+    /**
+     * Create empty chain.
+     * @param capacity Most cells.
+     */
+    inline Chain(int capacity) : cells(capacity), head(0), length(0) { assert(capacity > 0); }
+
+    inline int size() const { return length; }
+
+    inline bool empty() const { return length == 0; }
+
+    /**
+     * Return the i-th cell from the head.
+     */
+    inline const Cell& operator[](int i) const
+    {
+        assert(0 <= i && i < length);  // index must be valid
+        return cells[wrap(head + i)];
+    }
+
+    inline const Cell& front() const { return (*this)[0]; }
+
+    inline const Cell& back() const { return (*this)[length - 1]; }
+
+    inline Iterator begin() const { return Iterator(*this, 0); }
+
+    inline Iterator end() const { return Iterator(*this, length); }
+
+    /**
+     * Return the cells from head to tail, as the cells of the first span
+     * followed by those of the second, which may be empty.
+     */
+    inline std::array<std::span<const Cell>, 2> spans() const
+    {
+        const int first_size = std::min<int>(length, cells.size() - head);
+        return {
+            std::span<const Cell>(cells.data() + head, first_size),
+            std::span<const Cell>(cells.data(), length - first_size),
+        };
+    }
+
+    /**
+     * Add a cell in front of the head, which becomes the new head.
+     */
+    inline void push_front(const Cell& cell)
+    {
+        assert(length < static_cast<int>(cells.size()));  // chain must not be full
+        head = head == 0 ? cells.size() - 1 : head - 1;
+        cells[head] = cell;
+        ++length;
+    }
+
+    /**
+     * Add a cell behind the tail, which becomes the new tail.
+     */
+    inline void push_back(const Cell& cell)
+    {
+        assert(length < static_cast<int>(cells.size()));  // chain must not be full
+        cells[wrap(head + length)] = cell;
+        ++length;
+    }
+
+    /**
+     * Remove the tail.
+     */
+    inline void pop_back()
+    {
+        assert(length > 0);  // chain must not be empty
+        --length;
+    }
+
+private:
+    /**
+     * Wrap a position past the end of the buffer around to its start.
+     * @param i Position, less than twice the capacity.
+     */
+    inline int wrap(int i) const { return i < static_cast<int>(cells.size()) ? i : i - cells.size(); }
+
+    std::vector<Cell> cells;
+    // Position of the head in `cells`.
+    int head;
+    // Number of cells.
+    int length;
+};
+
+}  // namespace ngames::snake
@@ -0,0 +1,55 @@
+#include <ngames/snake/free_cells.hpp>
+
+#include <cassert>
+
+
+namespace ngames::snake
+{
+
+FreeCells::FreeCells(int rows, int cols) : rows(rows), cols(cols), positions(rows * cols)
+{
+    cells.reserve(rows * cols);
+    fill();
+}
+
+void FreeCells::fill()
+{
+    cells.clear();
+    for (int idx = 0; idx < rows * cols; ++idx) {
+        cells.push_back(idx);
+        positions[idx] = idx;
+    }
+}
+
+void FreeCells::insert(const std::pair<int, int>& cell)
+{
+    const int idx = cell.first * cols + cell.second;
+    assert(positions[idx] < 0);  // cell must not be in the set
+
+    positions[idx] = cells.size();
+    cells.push_back(idx);
+}
+
+void FreeCells::erase(const std::pair<int, int>& cell)
+{
+    const int idx = cell.first * cols + cell.second;
+    assert(positions[idx] >= 0);  // cell must be in the set
+
+    // replace the cell with the last one, to remove it in O(1) time
+    const int last = cells.back();
+    cells[positions[idx]] = last;
+    positions[last] = positions[idx];
+    cells.pop_back();
+    positions[idx] = -1;
+}
+
+std::optional<std::pair<int, int>> FreeCells::sample(std::mt19937& rng) const
+{
+    if (cells.empty()) {
+        return std::nullopt;
+    }
+    const int idx = cells[rng() % cells.size()];
+    return std::make_pair(idx / cols, idx % cols);
+}
+
+}  // namespace ngames::snake
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace ngames::snake
+{
+
+/**
+ * Set of the free cells of a board, i.e. those not occupied by a snake, as a
+ * dense array of cells with the position of each cell in the array. Inserting,
+ * erasing and drawing a random cell take constant time, and never allocate.
+ */
+class FreeCells
+{
+public:
+    /**
+     * Create set of all cells of a board.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     */
+    FreeCells(int rows, int cols);
+
+    /**
+     * Add every cell of the board.
+     */
+    void fill();
+
+    /**
+     * Add a cell, which must not be in the set.
+     * @param cell Cell (row, col).
+     */
+    void insert(const std::pair<int, int>& cell);
+
+    /**
+     * Remove a cell, which must be in the set.
+     * @param cell Cell (row, col).
+     */
+    void erase(const std::pair<int, int>& cell);
+
+    inline bool contains(const std::pair<int, int>& cell) const
+    {
+        return positions[cell.first * cols + cell.second] >= 0;
+    }
+
+    inline int size() const { return cells.size(); }
+
+    /**
+     * Draw a random cell of the set.
+     * @param rng Random number generator.
+     * @returns (row, col) of cell, or null if the set is empty.
+     */
+    std::optional<std::pair<int, int>> sample(std::mt19937& rng) const;
+
+    const int rows;
+    const int cols;
+
+private:
+    // Cells in the set, in no particular order.
+    // NOTE: we encode the pair (row, col) as a single index: row * cols + col
+    std::vector<int> cells;
+    // Position of each cell in `cells`, or -1 if not in the set.
+    std::vector<int> positions;
+};
+
+}  // namespace ngames::snake
@@ -6,14 +6,24 @@
 namespace ngames::snake
 {
 
-Snake::Snake(int head_row, int head_col, Direction direction, int length) : direction(direction)
+Snake::Snake(int rows, int cols, int head_row, int head_col, Direction direction, int length)
+    : direction(direction),
+      chain(rows * cols),
+      rows(rows),
+      cols(cols),
+      occupancy(rows * cols)
 {
     assert(length > 0);
 
     const auto [drow, dcol] = dir2vec(direction);
     // populate chain in a straight line
     for (int i = 0; i < length; ++i) {
-        chain.emplace_back(head_row - i * drow, head_col - i * dcol);
+        const int row = head_row - i * drow;
+        const int col = head_col - i * dcol;
+        assert(0 <= row && row < rows);
+        assert(0 <= col && col < cols);
+        chain.push_back({row, col});
+        occupancy[row * cols + col] = true;
     }
 }
 
@@ -26,43 +36,52 @@ std::pair<int, int> Snake::next_head(const Direction* dir) const
 
 void Snake::step(bool grow)
 {
-    chain.push_front(next_head());
+    const auto [row, col] = next_head();
+    assert(0 <= row && row < rows);
+    assert(0 <= col && col < cols);
+    // vacate the tail first, since the head may move into it
     if (!grow) {
+        const auto [tail_row, tail_col] = chain.back();
+        occupancy[tail_row * cols + tail_col] = false;
         chain.pop_back();
     }
+    chain.push_front({row, col});
+    occupancy[row * cols + col] = true;
 }
 
 void Snake::draw(WINDOW* window, attr_t head_attr, attr_t body_attr) const
 {
-    // draw snake body excluding head
+    // draw snake body excluding head, which starts the first span
+    const auto [first_span, second_span] = chain.spans();
     wattron(window, body_attr);
-    for (auto it = chain.begin() + 1; it != chain.end(); ++it) {
-        const auto [row, col] = *it;
+    for (const auto& [row, col] : first_span.subspan(1)) {
+        mvwaddch(window, row, col, '@');
+    }
+    for (const auto& [row, col] : second_span) {
         mvwaddch(window, row, col, '@');
     }
     wattroff(window, body_attr);
 
     // head is drawn specially
-    char head_char;
+    const auto [head_row, head_col] = chain.front();
+    wattron(window, head_attr);
+    mvwaddch(window, head_row, head_col, head_char());
+    wattroff(window, head_attr);
+}
+
+char Snake::head_char() const
+{
     switch (direction) {
         case ngames::snake::Direction::up:
-            head_char = '^';
-            break;
+            return '^';
         case ngames::snake::Direction::down:
-            head_char = 'v';
-            break;
+            return 'v';
         case ngames::snake::Direction::left:
-            head_char = '<';
-            break;
+            return '<';
         case ngames::snake::Direction::right:
-            head_char = '>';
-            break;
+            return '>';
     }
-    const auto [head_row, head_col] = chain.front();
-
-    wattron(window, head_attr);
-    mvwaddch(window, head_row, head_col, head_char);
-    wattroff(window, head_attr);
+    return '@';
 }
 
 }  // namespace ngames::snake
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <ngames/snake/chain.hpp>
 #include <ngames/snake/direction.hpp>
 
 #include <ncurses.h>
 
-#include <deque>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 
 namespace ngames::snake
@@ -16,12 +19,14 @@ namespace ngames::snake
 struct Snake {
     /**
      * Create new snake.
+     * @param rows Number of rows of the board.
+     * @param cols Number of columns of the board.
      * @param head_row Cell row for the snake head.
      * @param head_col Cell column for the snake head.
      * @param direction Direction for the snake.
      * @param length Length of snake, in number of characters.
      */
-    Snake(int head_row, int head_col, Direction direction, int length);
+    Snake(int rows, int cols, int head_row, int head_col, Direction direction, int length);
 
     /**
      * Returns the cell (row, col) in front of the snake.
@@ -30,11 +35,29 @@ struct Snake {
     std::pair<int, int> next_head(const Direction* dir = nullptr) const;
 
     /**
-     * Step the snake forward one cell. Does not check for any kind of collisions.
+     * Step the snake forward one cell. Does not check for any kind of
+     * collisions, but the new head must be on the board. Never allocates.
      * @param grow If true, does not delete the tail. Snake length increases by 1.
      */
     void step(bool grow);
 
+    /**
+     * Returns `true` if the snake occupies a cell. Takes constant time.
+     * @param row Cell row, on the board.
+     * @param col Cell column, on the board.
+     */
+    inline bool occupies(int row, int col) const { return occupancy[row * cols + col]; }
+
+    /**
+     * Returns `true` if a head moving into a cell would collide into the
+     * snake. The tail is excluded, since it will move away in time.
+     * @param cell Cell (row, col), on the board.
+     */
+    inline bool hits_itself(const std::pair<int, int>& cell) const
+    {
+        return occupies(cell.first, cell.second) && cell != chain.back();
+    }
+
     /**
      * Draw the snake on a window.
      * @param window Window.
@@ -43,12 +66,26 @@ struct Snake {
      */
     void draw(WINDOW* window, attr_t head_attr = 0, attr_t body_attr = 0) const;
 
+    /**
+     * Returns the character drawn for the head, pointing in the direction of
+     * the snake.
+     */
+    char head_char() const;
+
     // Direction of snake.
     Direction direction;
 
     // Chain of cells (row, col) that make up the snake body. Head is front of
-    // chain, and tail is back of chain.
-    std::deque<std::pair<int, int>> chain;
+    // chain, and tail is back of chain. Holds every cell of the board, so the
+    // snake never allocates as it grows.
+    Chain chain;
+
+private:
+    int rows;
+    int cols;
+    // Whether each cell is in `chain`, kept in sync by `step()`.
+    // NOTE: we encode the pair (row, col) as a single index: row * cols + col
+    std::vector<uint8_t> occupancy;
 };
 
 }  // namespace ngames::snake
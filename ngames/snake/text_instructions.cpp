@@ -17,9 +17,10 @@ void TextInstructions::refresh() const
     constexpr auto attr = COLOR_PAIR(COLOR_PAIR_INSTRUCTIONS);
     wattron(window, attr);
     mvwprintw(window, 0, 0, "move            hjkl / arrow keys");
-    mvwprintw(window, 1, 0, "refresh ui      r");
-    mvwprintw(window, 2, 0, "new game        z");
-    mvwprintw(window, 3, 0, "quit            q");
+    mvwprintw(window, 1, 0, "autopilot       a");
+    mvwprintw(window, 2, 0, "refresh ui      r");
+    mvwprintw(window, 3, 0, "new game        z");
+    mvwprintw(window, 4, 0, "quit            q");
     wattroff(window, attr);
     wnoutrefresh(window);
 }
@@ -12,7 +12,7 @@ namespace ngames::snake
 class TextInstructions : public Component
 {
 public:
-    static constexpr int HEIGHT = 4;
+    static constexpr int HEIGHT = 5;
     static constexpr int WIDTH = 80;
 
     /**
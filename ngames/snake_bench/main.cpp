@@ -0,0 +1,308 @@
+#include <ngames/snake/autopilot.hpp>
+#include <ngames/snake/board.hpp>
+#include <ngames/snake/direction.hpp>
+#include <ngames/snake/free_cells.hpp>
+#include <ngames/snake/snake.hpp>
+
+#include <ngames/common/histogram.hpp>
+
+#include <chrono>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+/**
+ * Print usage help text and then exit the program.
+ */
+[[noreturn]] static void help_and_exit()
+{
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  snake_bench [options]\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Moves snakes of growing lengths along a cycle covering the board, checking for collisions each\n");
+    fprintf(stderr, "tick like the game does, and reports ticks per second for each length. Compares the occupancy\n");
+    fprintf(stderr, "grid of the snake with scanning its whole chain.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "With -a, the autopilot plays games instead, as fast as it can, and reports ticks per second\n");
+    fprintf(stderr, "and the time it takes to decide each move.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  -a                     play games with the autopilot\n");
+    fprintf(stderr, "  -b <r> <c>             board size, with an even number of rows unless -a (default 1000 1000)\n");
+    fprintf(stderr, "  -t <ms>                least time measured per length, or in total with -a (default 200)\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Convert string to integer. If an error occurs, prints a helpful message to
+ * the user and then exits the program.
+ * @param str The string to convert.
+ */
+static int str_to_int(const char* str)
+{
+    int i;
+    size_t pos;
+    try {
+        i = std::stoi(str, &pos);
+    } catch (std::invalid_argument const&) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    } catch (std::out_of_range const&) {
+        fprintf(stderr, "Number too large: %s\n", str);
+        help_and_exit();
+    }
+    if (pos != std::strlen(str)) {
+        fprintf(stderr, "Not an integer: %s\n", str);
+        help_and_exit();
+    }
+    return i;
+}
+
+struct Args {
+    int rows = 1000;
+    int cols = 1000;
+    // Each length runs until its ticks take this long.
+    int min_ms = 200;
+    // Whether the autopilot plays games instead.
+    bool autopilot = false;
+};
+
+/**
+ * Parse command line arguments. If an error occurs, prints a helpful message
+ * to the user and then exits the program.
+ * @param argc
+ * @param argv
+ */
+static Args get_args(int argc, char** argv)
+{
+    Args args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h") {
+            help_and_exit();
+        } else if (arg == "-a") {
+            args.autopilot = true;
+            continue;
+        }
+        const int num_values = arg == "-b" ? 2 : 1;
+        if (i + num_values >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            help_and_exit();
+        }
+        if (arg == "-b") {
+            args.rows = str_to_int(argv[++i]);
+            args.cols = str_to_int(argv[++i]);
+        } else if (arg == "-t") {
+            args.min_ms = str_to_int(argv[++i]);
+        } else {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            help_and_exit();
+        }
+    }
+
+    if (args.autopilot ? args.rows < ngames::snake::Board::MIN_ROWS || args.cols < ngames::snake::Board::MIN_COLS
+                       : args.rows < 2 || args.rows % 2 != 0 || args.cols < 2) {
+        fprintf(stderr, "Invalid board size: %d %d\n", args.rows, args.cols);
+        help_and_exit();
+    }
+    if (args.min_ms < 0) {
+        fprintf(stderr, "Time must be positive.\n");
+        help_and_exit();
+    }
+    return args;
+}
+
+/**
+ * Return the direction of a cycle through every cell of the board: right
+ * along row 0, then back and forth through the other columns row by row, and
+ * up column 0 back to the start. Needs an even number of rows.
+ * @param args Arguments.
+ * @param row Cell row.
+ * @param col Cell column.
+ */
+static ngames::snake::Direction cycle_direction(const Args& args, int row, int col)
+{
+    if (col == 0) {
+        return row == 0 ? ngames::snake::Direction::right : ngames::snake::Direction::up;
+    }
+    if (row % 2 == 0) {
+        return col < args.cols - 1 ? ngames::snake::Direction::right : ngames::snake::Direction::down;
+    }
+    return col > 1 || row == args.rows - 1 ? ngames::snake::Direction::left : ngames::snake::Direction::down;
+}
+
+/**
+ * Returns `true` if a head moving into a cell would collide into the snake,
+ * by scanning the chain, as the game did before keeping an occupancy grid.
+ * @param snake Snake.
+ * @param cell Cell (row, col).
+ */
+static bool scan_hits_itself(const ngames::snake::Snake& snake, const std::pair<int, int>& cell)
+{
+    // the tail is excluded, since it will move away in time
+    for (const auto& span : snake.chain.spans()) {
+        for (const auto& body_cell : span) {
+            if (cell == body_cell) {
+                return &body_cell != &snake.chain.back();
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Tick a snake along the cycle until the least time has passed, checking for
+ * collisions with walls and itself like `snake::Board::tick()`.
+ * @param args Arguments.
+ * @param snake Snake.
+ * @param scan If true, check collisions by scanning the chain.
+ * @returns Ticks per second.
+ */
+static double run_ticks(const Args& args, ngames::snake::Snake& snake, bool scan)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::duration min_time = std::chrono::milliseconds(args.min_ms);
+    long ticks = 0;
+    long collisions = 0;
+    Clock::duration elapsed;
+    do {
+        // NOTE: check the clock every few ticks, since ticks are much faster
+        for (int i = 0; i < 64; ++i, ++ticks) {
+            const auto [head_row, head_col] = snake.chain.front();
+            snake.direction = cycle_direction(args, head_row, head_col);
+            const auto next_head = snake.next_head();
+            if (next_head.first < 0 || next_head.first >= args.rows || next_head.second < 0 ||
+                next_head.second >= args.cols) {
+                ++collisions;
+            } else if (scan ? scan_hits_itself(snake, next_head) : snake.hits_itself(next_head)) {
+                ++collisions;
+            }
+            snake.step(false);
+        }
+        elapsed = Clock::now() - start;
+    } while (elapsed < min_time);
+
+    // following the cycle never collides
+    if (collisions > 0) {
+        fprintf(stderr, "Snake collided %ld times.\n", collisions);
+        exit(EXIT_FAILURE);
+    }
+    return ticks / std::chrono::duration<double>(elapsed).count();
+}
+
+/**
+ * Play games with the autopilot until the least time has passed, stepping
+ * the snake like `snake::Board::tick()`, and print ticks per second and the
+ * time taken by each decision.
+ * @param args Arguments.
+ */
+static void run_autopilot(const Args& args)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const Clock::duration min_time = std::chrono::milliseconds(args.min_ms);
+    ngames::snake::Autopilot autopilot(args.rows, args.cols);
+    ngames::snake::FreeCells free_cells(args.rows, args.cols);
+    std::mt19937 rng(0);
+    long ticks = 0;
+    long apples = 0;
+    int wins = 0;
+    // Time taken by each decision, in nanoseconds.
+    ngames::Histogram decision_times;
+    Clock::duration elapsed;
+    do {
+        // new game, starting like `snake::Board::reset()`
+        constexpr int length = ngames::snake::Board::INIT_SNAKE_LENGTH;
+        ngames::snake::Snake snake(
+            args.rows, args.cols, length - 1, (args.cols - 1) / 2, ngames::snake::Direction::down, length);
+        free_cells.fill();
+        for (const auto& cell : snake.chain) {
+            free_cells.erase(cell);
+        }
+        std::optional<std::pair<int, int>> apple = free_cells.sample(rng);
+        if (autopilot.reset(snake) != 0) {
+            fprintf(stderr, "Autopilot cannot play the snake.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        while (apple.has_value()) {
+            const Clock::time_point t_decision = Clock::now();
+            snake.direction = autopilot.next_direction(snake, apple);
+            const Clock::time_point t_decided = Clock::now();
+            decision_times.record(std::chrono::duration_cast<std::chrono::nanoseconds>(t_decided - t_decision).count());
+
+            // the autopilot never collides
+            const auto next_head = snake.next_head();
+            if (next_head.first < 0 || next_head.first >= args.rows || next_head.second < 0 ||
+                next_head.second >= args.cols || snake.hits_itself(next_head)) {
+                fprintf(stderr, "Autopilot collided after %ld ticks.\n", ticks);
+                exit(EXIT_FAILURE);
+            }
+            const bool grow = next_head == *apple;
+            if (!grow) {
+                free_cells.insert(snake.chain.back());
+            }
+            snake.step(grow);
+            free_cells.erase(snake.chain.front());
+            if (grow) {
+                ++apples;
+                apple = free_cells.sample(rng);
+            }
+            ++ticks;
+
+            // games on large boards may last longer than the least time
+            if (t_decided - start >= min_time) {
+                break;
+            }
+        }
+        wins += !apple.has_value();
+        elapsed = Clock::now() - start;
+    } while (elapsed < min_time);
+
+    printf("autopilot ticks_per_sec=%.0f decision_mean_ns=%.0f decision_p50_ns=%llu decision_p99_ns=%llu "
+           "decision_max_us=%.1f apples=%ld wins=%d\n",
+           ticks / std::chrono::duration<double>(elapsed).count(),
+           decision_times.get_mean(),
+           static_cast<unsigned long long>(decision_times.percentile(50)),
+           static_cast<unsigned long long>(decision_times.percentile(99)),
+           decision_times.get_max() / 1e3,
+           apples,
+           wins);
+}
+
+int main(int argc, char** argv)
+{
+    const Args args = get_args(argc, argv);
+    if (args.autopilot) {
+        run_autopilot(args);
+        return EXIT_SUCCESS;
+    }
+
+    for (long length = 10; length < static_cast<long>(args.rows) * args.cols; length *= 10) {
+        // grow the snake along the cycle from its start
+        ngames::snake::Snake snake(args.rows, args.cols, 0, 0, ngames::snake::Direction::right, 1);
+        while (snake.chain.size() < length) {
+            const auto [head_row, head_col] = snake.chain.front();
+            snake.direction = cycle_direction(args, head_row, head_col);
+            snake.step(true);
+        }
+
+        const double grid_ticks_per_sec = run_ticks(args, snake, false);
+        const double scan_ticks_per_sec = run_ticks(args, snake, true);
+        printf("length=%ld grid_ticks_per_sec=%.0f scan_ticks_per_sec=%.0f speedup=%.1f\n",
+               length,
+               grid_ticks_per_sec,
+               scan_ticks_per_sec,
+               grid_ticks_per_sec / scan_ticks_per_sec);
+    }
+    return EXIT_SUCCESS;
+}
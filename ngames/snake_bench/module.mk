@@ -0,0 +1,14 @@
+snake_bench_sources := $(wildcard $(SRC)/snake_bench/*.cpp)
+snake_bench_objects := $(subst $(SRC),$(OBJ),$(snake_bench_sources:.cpp=.o))
+snake_bench_deps    := $(snake_bench_objects:.o=.d)
+
+apps    += $(BIN)/snake_bench
+sources += $(snake_bench_sources)
+objects += $(snake_bench_objects)
+deps    += $(snake_bench_deps)
+
+# steps snakes without a terminal
+snake_bench_objects += $(OBJ)/snake/snake.o $(OBJ)/snake/free_cells.o $(OBJ)/snake/autopilot.o
+
+.PHONY: snake_bench
+snake_bench: $(BIN)/snake_bench